@@ -0,0 +1,227 @@
+// Starts several copies of itself against one database and has each of
+// them look up and update a small set of students as fast as it can, the
+// way front-desk instances sharing a database file do: StudentRepository
+// calls wrapped in BusyRetry, updates checked against the version read.
+// Reports throughput, latency, busy retries and version conflicts, and
+// checks that no update was lost: every update that succeeded must show
+// up as exactly one version bump.
+// Usage: StudentContentionBench [--processes 4] [--seconds 5] [--rows 50]
+//                               [--reads 50]
+// (--worker <db> <seconds> <rows> <reads> <seed> is used by the children)
+
+#include "busyretry.h"
+#include "databaseservice.h"
+#include "studentrepository.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QVariant>
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+const char *const Grades[] = { "A", "B", "C", "D", "F" };
+
+QString rollNo(int i)
+{
+    return QString("C%1").arg(i, 5, 10, QChar('0'));
+}
+
+double percentile(std::vector<double> v, double p)
+{
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t rank = static_cast<size_t>(p * static_cast<double>(v.size()));
+    return v[std::min(rank, v.size() - 1)];
+}
+
+// ---------------- child ----------------
+
+int runWorker(const QString &dbPath, int seconds, int rows, int readPercent, quint32 seed)
+{
+    DatabaseService db("contention");
+    if (!db.open(dbPath)) {
+        std::fprintf(stderr, "worker: %s\n", qPrintable(db.lastError()));
+        return 1;
+    }
+    StudentRepository repository(&db);
+    BusyRetry retry;
+    std::mt19937 rng(seed);
+
+    qint64 reads = 0, updates = 0, conflicts = 0, errors = 0;
+    std::vector<double> us;
+    us.reserve(1 << 16);
+
+    QElapsedTimer clock;
+    clock.start();
+    while (clock.elapsed() < seconds * 1000) {
+        QElapsedTimer t;
+        t.start();
+
+        StudentRecord record;
+        const QString roll = rollNo(int(rng() % quint32(rows)));
+        const StudentRepository::Result got =
+            retry.run([&]() { return repository.get(roll, record); });
+        if (!got.ok || got.rows == 0) {
+            ++errors;
+            continue;
+        }
+
+        if (int(rng() % 100) < readPercent) {
+            ++reads;
+        } else {
+            // read-modify-write against the version just read
+            record.grade = Grades[rng() % std::size(Grades)];
+            const StudentRepository::Result put =
+                retry.run([&]() { return repository.update(record); });
+            if (!put.ok)
+                ++errors;
+            else if (put.conflict)
+                ++conflicts;
+            else if (put.rows == 1)
+                ++updates;
+        }
+        us.push_back(t.nsecsElapsed() / 1e3);
+    }
+
+    QJsonObject out;
+    out["reads"] = reads;
+    out["updates"] = updates;
+    out["conflicts"] = conflicts;
+    out["errors"] = errors;
+    out["retries"] = retry.retries();
+    out["exhausted"] = retry.exhausted();
+    out["p50_us"] = percentile(us, 0.50);
+    out["p99_us"] = percentile(us, 0.99);
+    out["max_us"] = percentile(us, 1.0);
+    const QByteArray line = QJsonDocument(out).toJson(QJsonDocument::Compact) + '\n';
+    std::fwrite(line.constData(), 1, size_t(line.size()), stdout);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+
+    if (args.size() == 7 && args.at(1) == "--worker")
+        return runWorker(args.at(2), args.at(3).toInt(), qMax(1, args.at(4).toInt()),
+                         args.at(5).toInt(), args.at(6).toUInt());
+
+    int processes = 4;
+    int seconds = 5;
+    int rows = 50;
+    int readPercent = 50;
+    for (int i = 1; i + 1 < args.size(); i += 2) {
+        const QString &flag = args.at(i);
+        const int value = args.at(i + 1).toInt();
+        if (flag == "--processes")     processes = qMax(1, value);
+        else if (flag == "--seconds")  seconds = qMax(1, value);
+        else if (flag == "--rows")     rows = qMax(1, value);
+        else if (flag == "--reads")    readPercent = qBound(0, value, 100);
+        else {
+            std::fprintf(stderr, "unknown option %s\n", qPrintable(flag));
+            return 2;
+        }
+    }
+
+    // ---- seed the shared database ----
+    QTemporaryDir dir;
+    const QString dbPath = dir.filePath("students.db");
+    {
+        DatabaseService db("contention-setup");
+        if (!db.open(dbPath)) {
+            std::fprintf(stderr, "%s\n", qPrintable(db.lastError()));
+            return 1;
+        }
+        QVector<StudentRecord> students;
+        for (int i = 0; i < rows; ++i)
+            students.append({ QString("Student %1").arg(i), rollNo(i), "Computer Science", "B" });
+        StudentRepository repository(&db);
+        const StudentRepository::Result seeded = repository.upsertMany(students);
+        if (!seeded.ok) {
+            std::fprintf(stderr, "seeding failed: %s\n", qPrintable(seeded.error));
+            return 1;
+        }
+    }
+
+    // ---- run the children side by side ----
+    std::vector<std::unique_ptr<QProcess>> children;
+    for (int p = 0; p < processes; ++p) {
+        auto child = std::make_unique<QProcess>();
+        child->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        child->start(QCoreApplication::applicationFilePath(),
+                     { "--worker", dbPath, QString::number(seconds), QString::number(rows),
+                       QString::number(readPercent), QString::number(1000 + p) });
+        children.push_back(std::move(child));
+    }
+
+    qint64 reads = 0, updates = 0, conflicts = 0, errors = 0, retries = 0, exhausted = 0;
+    double worstP99 = 0.0, worstMax = 0.0;
+    bool failed = false;
+
+    std::printf("%-8s %9s %9s %10s %8s %8s %10s %10s\n",
+                "process", "reads", "updates", "conflicts", "retries", "errors",
+                "p50 (us)", "p99 (us)");
+    for (int p = 0; p < processes; ++p) {
+        QProcess &child = *children[size_t(p)];
+        if (!child.waitForFinished((seconds + 60) * 1000) ||
+            child.exitStatus() != QProcess::NormalExit || child.exitCode() != 0) {
+            std::fprintf(stderr, "process %d failed\n", p);
+            child.kill();
+            failed = true;
+            continue;
+        }
+        const QJsonObject r = QJsonDocument::fromJson(child.readAllStandardOutput().trimmed()).object();
+        std::printf("%-8d %9lld %9lld %10lld %8lld %8lld %10.1f %10.1f\n", p,
+                    qint64(r["reads"].toDouble()), qint64(r["updates"].toDouble()),
+                    qint64(r["conflicts"].toDouble()), qint64(r["retries"].toDouble()),
+                    qint64(r["errors"].toDouble()),
+                    r["p50_us"].toDouble(), r["p99_us"].toDouble());
+        reads     += qint64(r["reads"].toDouble());
+        updates   += qint64(r["updates"].toDouble());
+        conflicts += qint64(r["conflicts"].toDouble());
+        errors    += qint64(r["errors"].toDouble());
+        retries   += qint64(r["retries"].toDouble());
+        exhausted += qint64(r["exhausted"].toDouble());
+        worstP99 = std::max(worstP99, r["p99_us"].toDouble());
+        worstMax = std::max(worstMax, r["max_us"].toDouble());
+    }
+
+    // ---- every successful update is one version bump ----
+    qint64 bumps = -1;
+    {
+        DatabaseService db("contention-check");
+        QSqlQuery query(db.open(dbPath) ? db.database() : QSqlDatabase());
+        if (query.exec("SELECT SUM(version - 1) FROM students") && query.next())
+            bumps = query.value(0).toLongLong();
+    }
+
+    const double ops = double(reads + updates + conflicts);
+    std::printf("\n%d processes on %d rows, %d%% reads, %d s\n",
+                processes, rows, readPercent, seconds);
+    std::printf("throughput        %.0f ops/s (%.0f updates/s)\n", ops / seconds,
+                double(updates) / seconds);
+    std::printf("worst p99 / max   %.1f / %.1f us\n", worstP99, worstMax);
+    std::printf("conflicts         %lld (%.2f%% of writes)\n", conflicts,
+                updates + conflicts ? 100.0 * double(conflicts) / double(updates + conflicts) : 0.0);
+    std::printf("busy retries      %lld, gave up %lld, other errors %lld\n",
+                retries, exhausted, errors - exhausted);
+    std::printf("version bumps     %lld for %lld updates%s\n", bumps, updates,
+                bumps == updates ? "" : "  <-- LOST OR PHANTOM UPDATES");
+
+    return failed || bumps != updates ? 1 : 0;
+}
@@ -0,0 +1,394 @@
+// Generates synthetic students and tickets at one or more scales in a
+// temporary database and times the data-layer operations the app runs,
+// through the same classes and prepared statements: lookup, insert,
+// update, delete and their batch forms, a student's tickets, an admin
+// ticket-queue page and roll-number completion.
+// Reports throughput, p50/p99/p999 latency, the database file size and
+// the roll-number index's load time and memory.
+// Usage: StudentDataBench [--scales 10000,100000,1000000] [--ops N]
+//                         [--seed N] [--json results.json]
+
+#include "databaseservice.h"
+#include "rollnoindex.h"
+#include "studentimporter.h"
+#include "studentrepository.h"
+#include "ticketlistmodel.h"
+#include "ticketstore.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int BatchRows = 100;
+
+const char *const FirstNames[] = {
+    "Aarav", "Amelia", "Chen", "Diego", "Emma", "Fatima", "Hiro", "Ines",
+    "Jonas", "Kavya", "Liam", "Mei", "Noah", "Olga", "Priya", "Rahul",
+    "Sofia", "Tariq", "Uma", "Yusuf",
+};
+const char *const LastNames[] = {
+    "Anderson", "Banerjee", "Costa", "Dubois", "Eriksen", "Fernandez",
+    "Gupta", "Hoffmann", "Ivanova", "Kim", "Larsen", "Mehta", "Nakamura",
+    "Okafor", "Patel", "Rossi", "Schmidt", "Tanaka", "Williams", "Zhang",
+};
+const char *const Courses[] = {
+    "Computer Science", "Mechanical Engineering", "Physics", "Mathematics",
+    "Economics", "Biology", "Chemistry", "History", "Electrical Engineering",
+    "Civil Engineering",
+};
+const char *const CourseCodes[] = { "CS", "ME", "PH", "MA", "EC", "BI", "CH", "HI", "EE", "CE" };
+const char *const Grades[] = { "A", "A", "B", "B", "B", "C", "C", "D", "F" };
+const char *const Subjects[] = {
+    "Wrong marks", "ID mismatch", "Missing grade", "Name spelling",
+    "Course change", "Duplicate record",
+};
+
+template <typename T, size_t N>
+const T &pick(const T (&items)[N], std::mt19937 &rng)
+{
+    return items[rng() % N];
+}
+
+QString fullName(std::mt19937 &rng)
+{
+    return QString::fromLatin1(pick(FirstNames, rng)) + ' ' + QString::fromLatin1(pick(LastNames, rng));
+}
+
+// year, course code and a running number, e.g. 2023CS004512
+QString rollNo(int i)
+{
+    return QString("%1%2%3").arg(2015 + i % 10).arg(CourseCodes[(i / 10) % 10])
+                            .arg(i, 7, 10, QChar('0'));
+}
+
+struct Samples {
+    QString name;
+    std::vector<double> us;
+    double seconds = 0.0;
+};
+
+double percentile(std::vector<double> v, double p)
+{
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t rank = static_cast<size_t>(p * static_cast<double>(v.size()));
+    return v[std::min(rank, v.size() - 1)];
+}
+
+// times op(i) for i in [0, count)
+Samples measure(const char *name, int count, const std::function<bool(int)> &op)
+{
+    Samples s;
+    s.name = name;
+    s.us.reserve(static_cast<size_t>(count));
+    QElapsedTimer total;
+    total.start();
+    for (int i = 0; i < count; ++i) {
+        QElapsedTimer t;
+        t.start();
+        if (!op(i)) {
+            std::fprintf(stderr, "%s failed at %d\n", name, i);
+            break;
+        }
+        s.us.push_back(t.nsecsElapsed() / 1e3);
+    }
+    s.seconds = total.nsecsElapsed() / 1e9;
+    return s;
+}
+
+qint64 fileSize(const QString &path)
+{
+    return QFileInfo(path).size() + QFileInfo(path + "-wal").size();
+}
+
+// ---------------- one scale ----------------
+
+QJsonObject runScale(int students, int ops, quint32 seed)
+{
+    std::mt19937 rng(seed);
+    QTemporaryDir dir;
+    const QString dbPath = dir.filePath("students.db");
+    const QString csvPath = dir.filePath("students.csv");
+    QJsonObject result;
+    result["students"] = students;
+
+    // ---- generate ----
+    {
+        QFile csv(csvPath);
+        if (!csv.open(QIODevice::WriteOnly)) {
+            result["error"] = "cannot write " + csvPath;
+            return result;
+        }
+        QByteArray buf;
+        buf.reserve(1 << 20);
+        buf += "name,rollno,course,grade\n";
+        for (int i = 0; i < students; ++i) {
+            buf += QByteArray(pick(FirstNames, rng)) + ' ' + pick(LastNames, rng) + ',' +
+                   rollNo(i).toLatin1() + ",\"" + pick(Courses, rng) + "\"," +
+                   pick(Grades, rng) + '\n';
+            if (buf.size() > (1 << 20) - 256) {
+                csv.write(buf);
+                buf.clear();
+            }
+        }
+        csv.write(buf);
+    }
+
+    // the import goes through the app's own bulk path
+    StudentImporter importer(dbPath, csvPath);
+    importer.run();
+    const StudentImporter::Result imported = importer.result();
+    if (!imported.error.isEmpty() || imported.imported != students) {
+        result["error"] = "import failed: " + imported.error;
+        return result;
+    }
+    result["import_rows_per_s"] = imported.seconds > 0 ? students / imported.seconds : 0.0;
+
+    DatabaseService db(QString("bench-%1").arg(students));
+    if (!db.open(dbPath)) {
+        result["error"] = db.lastError();
+        return result;
+    }
+    TicketStore tickets(&db);
+
+    // one ticket per ten students, most already resolved
+    const int ticketCount = qMax(1, students / 10);
+    {
+        QElapsedTimer t;
+        t.start();
+        db.database().transaction();
+        for (int i = 0; i < ticketCount; ++i) {
+            const qint64 id = tickets.raise(rollNo(int(rng() % quint32(students))),
+                                            pick(Subjects, rng), "Generated by the benchmark");
+            if (id > 0 && rng() % 10 < 7)
+                tickets.resolve(id);
+        }
+        db.database().commit();
+        result["ticket_rows_per_s"] = ticketCount / (t.nsecsElapsed() / 1e9);
+    }
+    result["tickets"] = ticketCount;
+
+    // a tickets.txt from older versions, whose subjects and messages are
+    // free text, has to move over whole
+    {
+        const QString legacyPath = dir.filePath("tickets.txt");
+        QFile legacy(legacyPath);
+        if (!legacy.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            result["error"] = "cannot write " + legacyPath;
+            return result;
+        }
+        legacy.write("1 legacy1 Wrong marks in physics open\n"
+                     "2 legacy1 Marks Missing cleared\n"
+                     "3 legacy2 Name spelling is wrong on the transcript\n");
+        legacy.close();
+        const int moved = tickets.importLegacyFile(legacyPath);
+        if (moved != 3 || tickets.ticketsFor("legacy1").size() != 2) {
+            result["error"] = "legacy ticket import failed: " + tickets.lastError();
+            return result;
+        }
+    }
+    result["file_bytes_loaded"] = fileSize(dbPath);
+
+    // ---- operations ----
+    std::vector<Samples> runs;
+
+    StudentRepository repository(&db);
+    auto randomStudent = [&](const QString &roll) {
+        return StudentRecord{ fullName(rng), roll, pick(Courses, rng), pick(Grades, rng) };
+    };
+
+    runs.push_back(measure("lookup", ops, [&](int) {
+        StudentRecord record;
+        return repository.get(rollNo(int(rng() % quint32(students))), record).rows == 1;
+    }));
+
+    runs.push_back(measure("insert", ops, [&](int i) {
+        return repository.add(randomStudent(rollNo(students + i))).rows == 1;
+    }));
+
+    runs.push_back(measure("update", ops, [&](int) {
+        return repository.update(randomStudent(rollNo(int(rng() % quint32(students))))).rows == 1;
+    }));
+
+    // removes the rows the insert run added
+    runs.push_back(measure("delete", ops, [&](int i) {
+        return repository.remove(rollNo(students + i)).rows == 1;
+    }));
+
+    // batches of BatchRows, so per-op figures are per batch
+    const int batchOps = qMax(1, ops / BatchRows);
+    QStringList rolls;
+    QVector<StudentRecord> batch;
+    QVector<StudentRecord> found;
+
+    runs.push_back(measure("get many", batchOps, [&](int) {
+        rolls.clear();
+        for (int r = 0; r < BatchRows; ++r)
+            rolls << rollNo(int(rng() % quint32(students)));
+        return repository.getMany(rolls, found).ok && !found.isEmpty();
+    }));
+
+    runs.push_back(measure("upsert many", batchOps, [&](int i) {
+        batch.clear();
+        for (int r = 0; r < BatchRows; ++r)
+            batch << randomStudent(rollNo(students + i * BatchRows + r));
+        return repository.upsertMany(batch).rows == BatchRows;
+    }));
+
+    runs.push_back(measure("delete many", batchOps, [&](int i) {
+        rolls.clear();
+        for (int r = 0; r < BatchRows; ++r)
+            rolls << rollNo(students + i * BatchRows + r);
+        return repository.deleteMany(rolls).rows == BatchRows;
+    }));
+
+    runs.push_back(measure("user tickets", ops, [&](int) {
+        tickets.ticketsFor(rollNo(int(rng() % quint32(students))));
+        return tickets.lastError().isEmpty();
+    }));
+
+    // what the admin queue does on open: count, then a page somewhere in it
+    TicketListModel model(db.database());
+    TicketListModel::Filter open;
+    open.status = "open";
+    model.setFilter(open);
+    const int queueOps = qMax(1, ops / 10);
+    runs.push_back(measure("ticket page", queueOps, [&](int) {
+        model.refresh();
+        if (model.rowCount() == 0)
+            return true;
+        const int row = int(rng() % quint32(model.rowCount()));
+        return model.data(model.index(row, TicketListModel::IdColumn)).isValid();
+    }));
+
+    // what an admin session loads at login, then a keystroke's worth of
+    // completion: a random roll number cut to 4..10 characters
+    RollNoIndex index;
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    if (!index.load(db.database())) {
+        result["error"] = "roll number index failed to load";
+        return result;
+    }
+    const double indexLoadMs = loadTimer.nsecsElapsed() / 1e6;
+    const qint64 indexBytes = index.bytesUsed();   // inserts below grow the vectors
+    result["rollno_index_load_ms"] = indexLoadMs;
+    result["rollno_index_bytes"] = indexBytes;
+
+    runs.push_back(measure("complete", ops, [&](int) {
+        const QString roll = rollNo(int(rng() % quint32(students)));
+        return !index.complete(roll.left(4 + int(rng() % 7))).isEmpty();
+    }));
+
+    runs.push_back(measure("index insert", ops, [&](int i) {
+        return index.insert(rollNo(students + i));
+    }));
+
+    runs.push_back(measure("index remove", ops, [&](int i) {
+        return index.remove(rollNo(students + i));
+    }));
+
+    result["file_bytes"] = fileSize(dbPath);
+
+    QJsonArray opsJson;
+    std::printf("\n%d students, %d tickets, %.1f MiB on disk, import %.0f rows/s\n",
+                students, ticketCount, fileSize(dbPath) / 1048576.0,
+                result["import_rows_per_s"].toDouble());
+    std::printf("roll number index: %.1f MiB (%.1f bytes each), loaded in %.0f ms\n",
+                indexBytes / 1048576.0, double(indexBytes) / students, indexLoadMs);
+    std::printf("%-14s %8s %12s %10s %10s %10s\n",
+                "operation", "n", "ops/s", "p50 (us)", "p99 (us)", "p999 (us)");
+    for (const Samples &s : runs) {
+        const double n = static_cast<double>(s.us.size());
+        const double perSec = s.seconds > 0 ? n / s.seconds : 0.0;
+        const double p50 = percentile(s.us, 0.50);
+        const double p99 = percentile(s.us, 0.99);
+        const double p999 = percentile(s.us, 0.999);
+        std::printf("%-14s %8zu %12.0f %10.1f %10.1f %10.1f\n",
+                    qPrintable(s.name), s.us.size(), perSec, p50, p99, p999);
+
+        QJsonObject o;
+        o["name"] = s.name;
+        o["count"] = static_cast<qint64>(s.us.size());
+        o["ops_per_s"] = perSec;
+        o["p50_us"] = p50;
+        o["p99_us"] = p99;
+        o["p999_us"] = p999;
+        opsJson.append(o);
+    }
+    result["operations"] = opsJson;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QList<int> scales = { 10000, 100000 };
+    int ops = 20000;
+    quint32 seed = 12345;
+    QString jsonPath;
+
+    const QStringList args = app.arguments();
+    for (int i = 1; i + 1 < args.size(); i += 2) {
+        const QString &flag = args.at(i);
+        const QString &value = args.at(i + 1);
+        if (flag == "--scales") {
+            scales.clear();
+            for (const QString &s : value.split(',', Qt::SkipEmptyParts))
+                if (s.toInt() > 0) scales << s.toInt();
+        } else if (flag == "--ops") {
+            ops = qMax(1, value.toInt());
+        } else if (flag == "--seed") {
+            seed = value.toUInt();
+        } else if (flag == "--json") {
+            jsonPath = value;
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", qPrintable(flag));
+            return 2;
+        }
+    }
+    if (scales.isEmpty()) return 2;
+
+    QJsonArray runs;
+    bool failed = false;
+    for (int students : scales) {
+        const QJsonObject r = runScale(students, ops, seed);
+        if (r.contains("error")) {
+            std::fprintf(stderr, "%d students: %s\n", students,
+                         qPrintable(r["error"].toString()));
+            failed = true;
+        }
+        runs.append(r);
+    }
+
+    if (!jsonPath.isEmpty()) {
+        QJsonObject doc;
+        doc["benchmark"] = "StudentDataBench";
+        doc["ops"] = ops;
+        doc["seed"] = static_cast<qint64>(seed);
+        doc["runs"] = runs;
+        QFile out(jsonPath);
+        if (!out.open(QIODevice::WriteOnly) ||
+            out.write(QJsonDocument(doc).toJson()) < 0) {
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(jsonPath));
+            return 1;
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+#include "backupscheduler.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+BackupScheduler::BackupScheduler(const QString &dbPath, const DatabaseBackup::Options &options,
+                                 int intervalMs, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_intervalMs(qMax(60 * 1000, intervalMs))
+    , m_backup(new DatabaseBackup(dbPath, options))
+{
+    m_thread.setObjectName("DatabaseBackup");
+    m_backup->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_backup, &QObject::deleteLater);
+
+    // queued: result() is read once the worker is done with it
+    connect(m_backup, &DatabaseBackup::finished, this, [this]() {
+        m_running = false;
+        m_timer.start(m_intervalMs);
+        emit backupFinished(m_backup->result());
+    }, Qt::QueuedConnection);
+
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &BackupScheduler::runNow);
+    m_thread.start(QThread::LowPriority);
+}
+
+BackupScheduler::~BackupScheduler()
+{
+    m_timer.stop();
+    m_backup->cancel();
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void BackupScheduler::start()
+{
+    qint64 dueInMs = StartupDelayMs;
+    const QStringList existing = DatabaseBackup::backups(m_options.dir);
+    if (!existing.isEmpty()) {
+        const qint64 age =
+            QFileInfo(existing.first()).lastModified().msecsTo(QDateTime::currentDateTime());
+        dueInMs = qMax<qint64>(StartupDelayMs, m_intervalMs - age);
+    }
+    m_timer.start(int(qMin<qint64>(dueInMs, m_intervalMs)));
+}
+
+void BackupScheduler::runNow()
+{
+    if (m_running)
+        return;
+    m_running = true;
+    QMetaObject::invokeMethod(m_backup, &DatabaseBackup::run, Qt::QueuedConnection);
+}
@@ -0,0 +1,41 @@
+#ifndef BACKUPSCHEDULER_H
+#define BACKUPSCHEDULER_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+
+#include "databasebackup.h"
+
+// Runs a DatabaseBackup on a thread of its own every interval. The first
+// run is timed from the newest backup already in the directory, so one
+// that fell due while the app was closed is taken shortly after start.
+class BackupScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultIntervalMs = 24 * 60 * 60 * 1000;
+    static constexpr int StartupDelayMs    = 60 * 1000;   // let the app settle first
+
+    BackupScheduler(const QString &dbPath, const DatabaseBackup::Options &options,
+                    int intervalMs = DefaultIntervalMs, QObject *parent = nullptr);
+    ~BackupScheduler() override;   // cancels a running backup and waits for it
+
+    void start();
+
+signals:
+    void backupFinished(const DatabaseBackup::Result &result);
+
+private:
+    DatabaseBackup::Options m_options;
+    int             m_intervalMs;
+    QThread         m_thread;
+    DatabaseBackup *m_backup;      // lives on m_thread
+    QTimer          m_timer;
+    bool            m_running = false;
+
+    void runNow();
+};
+
+#endif // BACKUPSCHEDULER_H
@@ -0,0 +1,27 @@
+#include "busyretry.h"
+
+#include <QRandomGenerator>
+#include <QThread>
+
+BusyRetry::BusyRetry(int attempts)
+    : m_attempts(qMax(1, attempts))
+{
+}
+
+bool BusyRetry::isBusy(const QString &nativeCode)
+{
+    bool ok = false;
+    const int code = nativeCode.toInt(&ok);
+    if (!ok)
+        return false;
+    const int primary = code & 0xff;
+    return primary == 5 || primary == 6;   // SQLITE_BUSY, SQLITE_LOCKED
+}
+
+// half the exponential step, plus a random part up to the other half
+void BusyRetry::pause(int attempt)
+{
+    const int step = qMin(MaxDelayMs, BaseDelayMs << qMin(attempt - 1, 16));
+    const int ms = step / 2 + int(QRandomGenerator::global()->bounded(step / 2 + 1));
+    QThread::msleep(ms);
+}
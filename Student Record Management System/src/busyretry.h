@@ -0,0 +1,56 @@
+#ifndef BUSYRETRY_H
+#define BUSYRETRY_H
+
+#include <QString>
+
+// Runs a database operation again while SQLite reports the database busy
+// or locked. The connection's busy timeout absorbs most waits, but it can
+// run out while another process holds the write lock, and a transaction
+// that read before it wrote fails straight away once someone else has
+// committed (SQLITE_BUSY_SNAPSHOT). Attempts back off exponentially with
+// jitter, so processes that collided once do not collide again in step.
+//
+// Not thread-safe; keep one per connection.
+class BusyRetry
+{
+public:
+    static constexpr int DefaultAttempts = 5;
+    static constexpr int BaseDelayMs     = 20;
+    static constexpr int MaxDelayMs      = 1000;
+
+    explicit BusyRetry(int attempts = DefaultAttempts);
+
+    // SQLITE_BUSY or SQLITE_LOCKED, extended codes included
+    static bool isBusy(const QString &nativeCode);
+
+    // op returns a result with ok and nativeCode, such as
+    // StudentRepository::Result or DbWorker::Reply. It must be safe to
+    // repeat after a busy failure, i.e. a failed statement or rolled-back
+    // transaction.
+    template <typename Op>
+    auto run(Op op) -> decltype(op())
+    {
+        auto result = op();
+        for (int attempt = 1; attempt < m_attempts && !result.ok &&
+                              isBusy(result.nativeCode); ++attempt) {
+            ++m_retries;
+            pause(attempt);
+            result = op();
+        }
+        if (!result.ok && isBusy(result.nativeCode))
+            ++m_exhausted;
+        return result;
+    }
+
+    qint64 retries() const { return m_retries; }
+    qint64 exhausted() const { return m_exhausted; }   // gave up, still busy
+
+private:
+    int    m_attempts;
+    qint64 m_retries = 0;
+    qint64 m_exhausted = 0;
+
+    static void pause(int attempt);
+};
+
+#endif // BUSYRETRY_H
@@ -0,0 +1,209 @@
+#include "credentialstore.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QTextStream>
+
+namespace {
+
+const QByteArray SchemeTag = "pbkdf2-sha256";
+
+struct ParsedHash {
+    int        iterations = 0;
+    QByteArray salt;
+    QByteArray key;
+};
+
+// "pbkdf2-sha256$<iterations>$<salt>$<key>"; false for a plain password
+bool parseHash(const QByteArray &secret, ParsedHash &out)
+{
+    const QList<QByteArray> parts = secret.split('$');
+    if (parts.size() != 4 || parts.at(0) != SchemeTag)
+        return false;
+    bool ok = false;
+    out.iterations = parts.at(1).toInt(&ok);
+    out.salt = QByteArray::fromBase64(parts.at(2));
+    out.key  = QByteArray::fromBase64(parts.at(3));
+    return ok && out.iterations > 0 && !out.salt.isEmpty() && !out.key.isEmpty();
+}
+
+// compares every byte, so the time taken says nothing about where they differ
+bool constantTimeEquals(const QByteArray &a, const QByteArray &b)
+{
+    if (a.size() != b.size())
+        return false;
+    unsigned char diff = 0;
+    for (int i = 0; i < a.size(); ++i)
+        diff |= static_cast<unsigned char>(a.at(i) ^ b.at(i));
+    return diff == 0;
+}
+
+} // namespace
+
+CredentialStore::CredentialStore(const QString &path, QObject *parent)
+    : QObject(parent)
+    , m_path(path)
+{
+    m_reloadTimer.setSingleShot(true);
+    m_reloadTimer.setInterval(100);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, [this]() {
+        m_reloadTimer.start();
+    });
+    connect(&m_reloadTimer, &QTimer::timeout, this, &CredentialStore::onFileChanged);
+}
+
+// RFC 8018 PBKDF2 with HMAC-SHA256 as the PRF
+QByteArray CredentialStore::pbkdf2Sha256(const QByteArray &password, const QByteArray &salt,
+                                         int iterations, int keyBytes)
+{
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, password);
+    QByteArray key;
+    for (quint32 block = 1; key.size() < keyBytes; ++block) {
+        const char index[4] = { char(block >> 24), char(block >> 16),
+                                char(block >> 8),  char(block) };
+        mac.reset();
+        mac.addData(salt);
+        mac.addData(index, 4);
+        QByteArray u = mac.result();
+        QByteArray t = u;
+        for (int i = 1; i < iterations; ++i) {
+            mac.reset();
+            mac.addData(u);
+            u = mac.result();
+            for (int j = 0; j < t.size(); ++j)
+                t[j] = char(t.at(j) ^ u.at(j));
+        }
+        key += t;
+    }
+    key.truncate(keyBytes);
+    return key;
+}
+
+QByteArray CredentialStore::hashSecret(const QByteArray &password) const
+{
+    QByteArray salt(SaltBytes, Qt::Uninitialized);
+    QRandomGenerator::system()->generate(salt.begin(), salt.end());
+    const QByteArray key = pbkdf2Sha256(password, salt, m_iterations);
+    return SchemeTag + '$' + QByteArray::number(m_iterations) + '$' +
+           salt.toBase64() + '$' + key.toBase64();
+}
+
+bool CredentialStore::needsUpgrade(const QByteArray &secret) const
+{
+    ParsedHash parsed;
+    return !parseHash(secret, parsed) || parsed.iterations < m_iterations;
+}
+
+// ---------------- file ----------------
+
+bool CredentialStore::load()
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_error = "Cannot open " + m_path + ": " + file.errorString();
+        return false;
+    }
+
+    QVector<Account> accounts;
+    QHash<QString, int> index;
+    // any run of blanks or tabs separates the fields, as with the old >> scan
+    static const QRegularExpression separators("\\s+");
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QStringList parts = in.readLine().split(separators, Qt::SkipEmptyParts);
+        if (parts.size() < 3)
+            continue;
+        // the first line for a user wins, as it did with the old scan
+        const auto it = index.constFind(parts.at(0));
+        if (it != index.constEnd())
+            continue;
+        index.insert(parts.at(0), accounts.size());
+        accounts.append({ parts.at(0), parts.at(1).toUtf8(), parts.at(2) });
+    }
+
+    m_accounts = std::move(accounts);
+    m_index = std::move(index);
+    m_index.squeeze();
+
+    // editors often replace the file, which drops it from the watch list
+    if (!m_watcher.files().contains(m_path))
+        m_watcher.addPath(m_path);
+    emit reloaded(m_accounts.size());
+    return true;
+}
+
+bool CredentialStore::save()
+{
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_error = "Cannot write " + m_path + ": " + file.errorString();
+        return false;
+    }
+    QByteArray out;
+    for (const Account &a : m_accounts)
+        out += a.user.toUtf8() + ' ' + a.secret + ' ' + a.role.toUtf8() + '\n';
+    file.write(out);
+    if (!file.commit()) {
+        m_error = "Cannot write " + m_path + ": " + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void CredentialStore::onFileChanged()
+{
+    if (QFileInfo::exists(m_path))
+        load();
+}
+
+// ---------------- accounts ----------------
+
+QString CredentialStore::authenticate(const QString &user, const QString &password)
+{
+    const auto it = m_index.constFind(user);
+    if (it == m_index.constEnd()) {
+        // same work as a real check, so a miss is not faster than a bad password
+        pbkdf2Sha256(password.toUtf8(), QByteArray(SaltBytes, '\0'), m_iterations);
+        return QString();
+    }
+    Account &account = m_accounts[*it];
+    const QByteArray pass = password.toUtf8();
+
+    ParsedHash parsed;
+    bool ok;
+    if (parseHash(account.secret, parsed))
+        ok = constantTimeEquals(pbkdf2Sha256(pass, parsed.salt, parsed.iterations,
+                                             parsed.key.size()),
+                                parsed.key);
+    else
+        ok = constantTimeEquals(pass, account.secret);
+    if (!ok)
+        return QString();
+
+    if (needsUpgrade(account.secret)) {
+        account.secret = hashSecret(pass);
+        save();   // a failure only means the upgrade is retried next time
+    }
+    return account.role;
+}
+
+int CredentialStore::upgradeAll()
+{
+    int upgraded = 0;
+    for (Account &a : m_accounts) {
+        ParsedHash parsed;
+        if (parseHash(a.secret, parsed)) {
+            // a weak hash can only be strengthened with the password
+            continue;
+        }
+        a.secret = hashSecret(a.secret);
+        ++upgraded;
+    }
+    if (upgraded > 0 && !save())
+        return -1;
+    return upgraded;
+}
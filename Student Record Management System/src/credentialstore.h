@@ -0,0 +1,82 @@
+#ifndef CREDENTIALSTORE_H
+#define CREDENTIALSTORE_H
+
+#include <QByteArray>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+// Login accounts from credentials.txt, held in memory and looked up by
+// user name in a hash table. The file is watched and reloaded when it
+// changes on disk.
+//
+// One account per line, whitespace separated:
+//     <user> pbkdf2-sha256$<iterations>$<salt>$<key> <role>
+// salt and key in base64. Lines written by older versions keep the
+// password in plain text instead; such an account is rewritten with a
+// hash the first time its user logs in (or all at once by
+// upgradeAll()), as is one hashed with fewer iterations than configured.
+class CredentialStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultIterations = 100000;
+    static constexpr int SaltBytes = 16;
+    static constexpr int KeyBytes  = 32;
+
+    explicit CredentialStore(const QString &path, QObject *parent = nullptr);
+
+    // PBKDF2 iterations for new hashes; the deliberate cost of a login
+    void setIterations(int iterations) { m_iterations = qMax(1, iterations); }
+    int iterations() const { return m_iterations; }
+
+    // reads the file and starts watching it; false if it cannot be read
+    bool load();
+
+    // the account's role ("admin", "student", "guest"), or an empty
+    // string if the user is unknown or the password is wrong
+    QString authenticate(const QString &user, const QString &password);
+
+    // hashes every plain-text account and saves; returns how many were
+    // rewritten, or -1 on failure. Weaker hashes need the password and
+    // are only strengthened at login.
+    int upgradeAll();
+
+    int accountCount() const { return m_accounts.size(); }
+    QString path() const { return m_path; }
+    QString lastError() const { return m_error; }
+
+    static QByteArray pbkdf2Sha256(const QByteArray &password, const QByteArray &salt,
+                                   int iterations, int keyBytes = KeyBytes);
+
+signals:
+    void reloaded(int accounts);
+
+private:
+    struct Account {
+        QString    user;
+        QByteArray secret;   // hash field as stored, or the plain password
+        QString    role;
+    };
+
+    QString m_path;
+    QString m_error;
+    int     m_iterations = DefaultIterations;
+
+    QVector<Account>    m_accounts;   // file order, for saving
+    QHash<QString, int> m_index;      // user -> m_accounts
+
+    QFileSystemWatcher m_watcher;
+    QTimer             m_reloadTimer;   // coalesces bursts of change events
+
+    QByteArray hashSecret(const QByteArray &password) const;
+    bool needsUpgrade(const QByteArray &secret) const;
+    bool save();
+    void onFileChanged();
+};
+
+#endif // CREDENTIALSTORE_H
@@ -0,0 +1,340 @@
+#include "databasebackup.h"
+#include "databaseservice.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSqlDatabase>
+#include <QSqlDriver>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+#include <QtEndian>
+
+#ifdef SRM_SQLITE_BACKUP_API
+#include <sqlite3.h>
+#ifdef __linux__
+#include <dlfcn.h>
+#include <link.h>
+#endif
+#endif
+
+namespace {
+
+const QByteArray CompressedMagic = "SRMBKZ1\n";
+
+#if defined(SRM_SQLITE_BACKUP_API) && defined(__linux__)
+// dl_iterate_phdr callback: stores the path of the loaded Qt SQLite driver
+int findSqliteDriver(struct dl_phdr_info *info, size_t, void *path)
+{
+    if (!QFileInfo(QFile::decodeName(info->dlpi_name)).fileName().startsWith("libqsqlite"))
+        return 0;
+    *static_cast<QByteArray *>(path) = info->dlpi_name;
+    return 1;
+}
+#endif
+
+} // namespace
+
+DatabaseBackup::DatabaseBackup(const QString &dbPath, const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_dbPath(dbPath)
+    , m_options(options)
+{
+}
+
+QStringList DatabaseBackup::backups(const QString &dir)
+{
+    // the timestamp in the name sorts in time order
+    const QDir d(dir);
+    QStringList paths;
+    const QStringList names = d.entryList({ "students-*.db", "students-*.db.qz" },
+                                          QDir::Files, QDir::Name | QDir::Reversed);
+    for (const QString &name : names)
+        paths << d.filePath(name);
+    return paths;
+}
+
+void DatabaseBackup::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_result = Result();
+    m_cancel.store(false);
+
+    const QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss");
+    const QString base = QDir(m_options.dir).filePath("students-" + stamp + ".db");
+    const QString partial = base + ".partial";
+    const QString target = m_options.compress ? base + ".qz" : base;
+
+    bool ok = QDir().mkpath(m_options.dir);
+    if (!ok)
+        m_result.error = "Cannot create " + m_options.dir;
+
+    if (ok) {
+        // connection names are per thread and per backup
+        const QString connectionName =
+            QString("students-backup-%1").arg(reinterpret_cast<quintptr>(this), 0, 16);
+        QFile::remove(partial);
+        ok = copyTo(connectionName, partial) && verify(partial);
+        if (ok && m_options.compress) {
+            ok = compress(partial, target);
+            QFile::remove(partial);
+        } else if (ok && !QFile::rename(partial, target)) {
+            m_result.error = "Cannot rename the backup to " + target;
+            ok = false;
+        }
+    }
+    if (!ok)
+        QFile::remove(partial);
+
+    if (ok) {
+        m_result.file = target;
+        m_result.fileBytes = QFileInfo(target).size();
+        rotate();
+    }
+    m_result.seconds = timer.nsecsElapsed() / 1e9;
+    emit finished();
+}
+
+bool DatabaseBackup::copyTo(const QString &connectionName, const QString &path)
+{
+    bool ok = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(m_dbPath);
+        db.setConnectOptions(QString("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=%1")
+                                 .arg(DatabaseService::BusyTimeoutMs));
+        if (!db.open()) {
+            m_result.error = db.lastError().text();
+        } else {
+#ifdef SRM_SQLITE_BACKUP_API
+            ok = sameLibrary() ? stepCopy(db, path) : vacuumInto(db, path);
+#else
+            ok = vacuumInto(db, path);
+#endif
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return ok;
+}
+
+#ifdef SRM_SQLITE_BACKUP_API
+// The backup calls below come from the library this program links and run
+// on the handle of Qt's driver, which is only sound if the driver uses that
+// very library: a copy built into the driver has its own mutexes and
+// allocator even at the same version. dlsym() through the driver finds the
+// function it would call; anything else, or no way to tell, gets VACUUM
+// INTO (so does a non-PIE build, where &sqlite3_backup_init is a PLT stub).
+bool DatabaseBackup::sameLibrary()
+{
+#ifdef __linux__
+    QByteArray driver;
+    dl_iterate_phdr(findSqliteDriver, &driver);
+    if (driver.isEmpty())
+        return false;   // linked in statically, so it has its own copy
+    void *plugin = dlopen(driver.constData(), RTLD_LAZY | RTLD_NOLOAD);
+    if (!plugin)
+        return false;
+    void *theirs = dlsym(plugin, "sqlite3_backup_init");
+    dlclose(plugin);
+    return theirs && theirs == reinterpret_cast<void *>(&sqlite3_backup_init);
+#else
+    return false;
+#endif
+}
+
+bool DatabaseBackup::stepCopy(const QSqlDatabase &db, const QString &path)
+{
+    bool ok = false;
+    qint64 pageSize = 0;
+    {
+        QSqlQuery query(db);
+        if (query.exec("PRAGMA page_size") && query.next())
+            pageSize = query.value(0).toLongLong();
+    }
+
+    const QVariant handle = db.driver()->handle();
+    sqlite3 *source = nullptr;
+    if (handle.isValid() && qstrcmp(handle.typeName(), "sqlite3*") == 0)
+        source = *static_cast<sqlite3 *const *>(handle.constData());
+
+    sqlite3 *target = nullptr;
+    if (!source) {
+        m_result.error = "The SQLite driver does not expose its handle.";
+    } else if (sqlite3_open_v2(QFile::encodeName(path).constData(), &target,
+                               SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                               nullptr) != SQLITE_OK) {
+        m_result.error = QString::fromUtf8(sqlite3_errmsg(target));
+    } else if (sqlite3_backup *backup =
+                   sqlite3_backup_init(target, "main", source, "main")) {
+        int rc = SQLITE_OK;
+        int last = -1;
+        bool oneStep = false;
+        qint64 pagesRead = 0;
+        while (true) {
+            rc = sqlite3_backup_step(backup, oneStep ? -1 : PagesPerStep);
+            const int total = sqlite3_backup_pagecount(backup);
+            const int remaining = sqlite3_backup_remaining(backup);
+            if (last >= 0 && remaining > last) {
+                // another connection wrote; the copy started over
+                if (++m_result.restarts >= MaxRestarts)
+                    oneStep = true;
+                pagesRead += total - remaining;
+            } else {
+                pagesRead += (last < 0 ? total : last) - remaining;
+            }
+            last = remaining;
+            emit progress(total - remaining, total);
+
+            if (rc == SQLITE_DONE || m_cancel.load(std::memory_order_relaxed))
+                break;
+            if (rc != SQLITE_OK && rc != SQLITE_BUSY && rc != SQLITE_LOCKED)
+                break;
+            sqlite3_sleep(StepPauseMs);   // the source is unlocked between steps
+        }
+        sqlite3_backup_finish(backup);
+        m_result.bytesCopied = pagesRead * pageSize;
+
+        if (rc == SQLITE_DONE && !m_cancel.load()) {
+            // a self-contained file, with no -wal beside it
+            sqlite3_exec(target, "PRAGMA journal_mode = DELETE", nullptr, nullptr, nullptr);
+            ok = true;
+        } else if (m_cancel.load()) {
+            m_result.cancelled = true;
+            m_result.error = "Backup cancelled.";
+        } else {
+            m_result.error = QString::fromUtf8(sqlite3_errstr(rc));
+        }
+    } else {
+        m_result.error = QString::fromUtf8(sqlite3_errmsg(target));
+    }
+    if (target)
+        sqlite3_close(target);
+    return ok;
+}
+#endif
+
+// one read transaction for the whole copy; writers carry on in WAL
+bool DatabaseBackup::vacuumInto(const QSqlDatabase &db, const QString &path)
+{
+    bool ok = false;
+    QSqlQuery query(db);
+    query.prepare("VACUUM INTO :path");
+    query.bindValue(":path", path);
+    if (query.exec()) {
+        m_result.bytesCopied = QFileInfo(path).size();
+        emit progress(1, 1);
+        ok = true;
+    } else {
+        m_result.error = query.lastError().text();
+    }
+    return ok;
+}
+
+bool DatabaseBackup::verify(const QString &path)
+{
+    const QString connectionName =
+        QString("students-backup-check-%1").arg(reinterpret_cast<quintptr>(this), 0, 16);
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(path);
+        db.setConnectOptions("QSQLITE_OPEN_READONLY");
+        if (!db.open()) {
+            m_result.error = "Cannot open the backup: " + db.lastError().text();
+        } else {
+            // a single "ok" row, or one row per problem found
+            QSqlQuery query(db);
+            if (!query.exec("PRAGMA quick_check")) {
+                m_result.error = "quick_check failed: " + query.lastError().text();
+            } else {
+                QStringList problems;
+                while (query.next() && problems.size() < 5)
+                    problems << query.value(0).toString();
+                m_result.verified = problems == QStringList{ "ok" };
+                if (!m_result.verified)
+                    m_result.error = "The backup failed quick_check:\n" + problems.join('\n');
+            }
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return m_result.verified;
+}
+
+// "SRMBKZ1\n", then per chunk a big-endian quint32 length and that many
+// bytes of qCompress output
+bool DatabaseBackup::compress(const QString &from, const QString &to)
+{
+    QFile in(from);
+    QSaveFile out(to);
+    if (!in.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly)) {
+        m_result.error = "Cannot compress the backup: " +
+                         (in.isOpen() ? out.errorString() : in.errorString());
+        return false;
+    }
+    out.write(CompressedMagic);
+    while (!in.atEnd()) {
+        if (m_cancel.load(std::memory_order_relaxed)) {
+            m_result.cancelled = true;
+            m_result.error = "Backup cancelled.";
+            return false;   // QSaveFile discards the partial file
+        }
+        const QByteArray packed = qCompress(in.read(ChunkBytes));
+        const quint32 length = qToBigEndian(quint32(packed.size()));
+        out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+        out.write(packed);
+    }
+    if (!out.commit()) {
+        m_result.error = "Cannot write " + to + ": " + out.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseBackup::unpack(const QString &from, const QString &to, QString *error)
+{
+    auto fail = [error](const QString &text) {
+        if (error)
+            *error = text;
+        return false;
+    };
+
+    QFile in(from);
+    if (!in.open(QIODevice::ReadOnly))
+        return fail(in.errorString());
+    if (in.read(CompressedMagic.size()) != CompressedMagic)
+        return fail(from + " is not a compressed backup.");
+
+    QSaveFile out(to);
+    if (!out.open(QIODevice::WriteOnly))
+        return fail(out.errorString());
+    while (!in.atEnd()) {
+        quint32 length = 0;
+        if (in.read(reinterpret_cast<char *>(&length), sizeof(length)) != sizeof(length))
+            return fail(from + " is truncated.");
+        const QByteArray packed = in.read(qFromBigEndian(length));
+        const QByteArray chunk = qUncompress(packed);
+        if (chunk.isEmpty())
+            return fail(from + " is damaged.");
+        out.write(chunk);
+    }
+    if (!out.commit())
+        return fail(out.errorString());
+    return true;
+}
+
+void DatabaseBackup::rotate()
+{
+    if (m_options.keep <= 0)
+        return;
+    const QStringList existing = backups(m_options.dir);
+    for (int i = m_options.keep; i < existing.size(); ++i) {
+        if (QFile::remove(existing.at(i)))
+            m_result.removed << existing.at(i);
+    }
+}
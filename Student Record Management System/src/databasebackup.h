@@ -0,0 +1,92 @@
+#ifndef DATABASEBACKUP_H
+#define DATABASEBACKUP_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+
+class QSqlDatabase;
+
+// Takes a consistent copy of the live database while the app keeps
+// using it, into "<dir>/students-<yyyyMMdd-HHmmss>.db" (".db.qz" when
+// compressed), and keeps the newest Options::keep of them.
+//
+// The copy goes through the SQLite backup API, PagesPerStep pages at a
+// time with a pause between steps, on its own read-only connection; in
+// WAL mode readers never block writers, so edits and imports carry on.
+// A write from another connection restarts the copy, so after
+// MaxRestarts restarts the rest is copied in a single step. Builds
+// without SRM_SQLITE_BACKUP_API use VACUUM INTO instead, in one step, as
+// do builds whose Qt SQLite driver turns out to carry its own SQLite.
+//
+// Each copy is written under a ".partial" name, checked with PRAGMA
+// quick_check and only then renamed, so a file with the final name is
+// always complete. Compressed copies are chunks of qCompress output;
+// unpack() turns one back into a database file.
+//
+// run() opens its own connection, so the backup can be moved to a worker
+// thread; cancel() may be called from any thread.
+class DatabaseBackup : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int PagesPerStep = 256;   // 1 MiB at 4 KiB pages
+    static constexpr int StepPauseMs  = 5;
+    static constexpr int MaxRestarts  = 3;
+    static constexpr int ChunkBytes   = 1 << 20;
+
+    struct Options {
+        QString dir;              // created if missing
+        int     keep = 7;         // older backups are deleted
+        bool    compress = false;
+    };
+
+    struct Result {
+        QString file;             // the finished backup
+        qint64  bytesCopied = 0;  // database pages read
+        qint64  fileBytes = 0;    // size on disk, after compression
+        int     restarts = 0;
+        bool    verified = false; // quick_check passed
+        bool    cancelled = false;
+        double  seconds = 0.0;
+        QStringList removed;      // rotated out
+        QString error;            // empty on success
+    };
+
+    DatabaseBackup(const QString &dbPath, const Options &options, QObject *parent = nullptr);
+
+    // backups in dir, newest first
+    static QStringList backups(const QString &dir);
+
+    // a compressed backup back into a database file
+    static bool unpack(const QString &from, const QString &to, QString *error = nullptr);
+
+    void cancel() { m_cancel.store(true); }
+    Result result() const { return m_result; }
+
+public slots:
+    void run();
+
+signals:
+    void progress(qint64 pagesDone, qint64 pagesTotal);
+    void finished();
+
+private:
+    QString m_dbPath;
+    Options m_options;
+    Result  m_result;
+    std::atomic<bool> m_cancel{false};
+
+    bool copyTo(const QString &connectionName, const QString &path);
+    static bool sameLibrary();
+    bool stepCopy(const QSqlDatabase &db, const QString &path);
+    bool vacuumInto(const QSqlDatabase &db, const QString &path);
+    bool verify(const QString &path);
+    bool compress(const QString &from, const QString &to);
+    void rotate();
+};
+
+#endif // DATABASEBACKUP_H
@@ -0,0 +1,177 @@
+#include "databaseservice.h"
+#include "schemamigrator.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QVariant>
+
+namespace {
+
+const char *const statementNames[DatabaseService::StatementCount] = {
+    "select student",
+    "insert student",
+    "update student",
+    "update student if unchanged",
+    "delete student",
+    "insert ticket",
+    "resolve ticket",
+    "user tickets",
+    "count open tickets",
+};
+
+const char *const statementSql[DatabaseService::StatementCount] = {
+    "SELECT name, course, grade, version FROM students WHERE rollno = :r",
+
+    "INSERT INTO students (name, rollno, course, grade) "
+    "VALUES (:name, :rollno, :course, :grade)",
+
+    "UPDATE students "
+    "SET name = :name, course = :course, grade = :grade, version = version + 1 "
+    "WHERE rollno = :roll",
+
+    "UPDATE students "
+    "SET name = :name, course = :course, grade = :grade, version = version + 1 "
+    "WHERE rollno = :roll AND version = :version",
+
+    "DELETE FROM students WHERE rollno = :roll",
+
+    "INSERT INTO tickets (user, subject, message, created_at) "
+    "VALUES (:user, :subject, :message, :created)",
+
+    "UPDATE tickets SET status = 'resolved', resolved_at = :resolved "
+    "WHERE id = :id AND status = 'open'",
+
+    "SELECT id, user, subject, message, status, created_at FROM tickets "
+    "WHERE user = :user ORDER BY id DESC",
+
+    "SELECT COUNT(*) FROM tickets WHERE status = 'open'",
+};
+
+} // namespace
+
+DatabaseService::DatabaseService(const QString &connectionName)
+    : m_connectionName(connectionName)
+{
+}
+
+DatabaseService::~DatabaseService()
+{
+    const QString report = timingReport();
+    if (!report.isEmpty())
+        qInfo().noquote() << report;
+
+    // queries and the handle must be gone before the connection is removed
+    for (auto &query : m_queries)
+        query.reset();
+    if (m_db.isOpen())
+        m_db.close();
+    m_db = QSqlDatabase();
+    if (QSqlDatabase::contains(m_connectionName))
+        QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+bool DatabaseService::open(const QString &path)
+{
+    m_error.clear();
+    m_duplicates.clear();
+
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_db.setDatabaseName(path);
+    m_db.setConnectOptions(QString("QSQLITE_BUSY_TIMEOUT=%1").arg(BusyTimeoutMs));
+    if (!m_db.open()) {
+        m_error = m_db.lastError().text();
+        return false;
+    }
+    if (!applyPragmas())
+        return false;
+
+    SchemaMigrator migrator(m_db);
+    const bool migrated = migrator.migrate();
+    m_duplicates = migrator.duplicateRollNos();
+    if (!migrated) {
+        m_error = migrator.lastError();
+        return false;
+    }
+    return true;
+}
+
+// WAL lets readers run alongside the writer; NORMAL sync is durable across
+// application crashes in WAL mode and skips most fsyncs. WAL coordinates
+// through shared memory, so every process opening the file has to run on
+// the same host; it does not work across machines on a network share.
+bool DatabaseService::applyPragmas()
+{
+    static const char *const pragmas[] = {
+        "PRAGMA journal_mode = WAL",
+        "PRAGMA synchronous = NORMAL",
+        "PRAGMA cache_size = -16384",       // KiB, i.e. 16 MiB of page cache
+        "PRAGMA mmap_size = 268435456",     // 256 MiB
+        "PRAGMA temp_store = MEMORY",
+    };
+
+    QSqlQuery query(m_db);
+    for (const char *sql : pragmas) {
+        if (!query.exec(sql)) {
+            m_error = QString("%1 failed: %2").arg(sql, query.lastError().text());
+            return false;
+        }
+    }
+    return true;
+}
+
+QSqlQuery &DatabaseService::statement(Statement s)
+{
+    std::unique_ptr<QSqlQuery> &query = m_queries[s];
+    if (!query)
+        query = std::make_unique<QSqlQuery>(m_db);
+
+    if (m_prepared[s]) {
+        query->finish();
+    } else {
+        // a failed prepare is retried on the next use
+        QElapsedTimer timer;
+        timer.start();
+        m_prepared[s] = query->prepare(statementSql[s]);
+        m_timings[s].prepareNs += timer.nsecsElapsed();
+    }
+    return *query;
+}
+
+bool DatabaseService::exec(Statement s)
+{
+    if (!m_queries[s] || !m_prepared[s])
+        return false;   // lastError() on the query says why
+    QSqlQuery &query = *m_queries[s];
+
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = query.exec();
+    const qint64 ns = timer.nsecsElapsed();
+
+    Timing &t = m_timings[s];
+    ++t.execCount;
+    t.execNs += ns;
+    t.maxExecNs = qMax(t.maxExecNs, ns);
+    return ok;
+}
+
+QString DatabaseService::timingReport() const
+{
+    QString report;
+    for (int s = 0; s < StatementCount; ++s) {
+        const Timing &t = m_timings[s];
+        if (!m_queries[s] && t.execCount == 0)
+            continue;
+        if (report.isEmpty())
+            report = "statement        prepare(us)  execs   avg(us)   max(us)";
+        const double avgUs = t.execCount ? t.execNs / 1000.0 / t.execCount : 0.0;
+        report += QString("\n%1 %2 %3 %4 %5")
+                      .arg(statementNames[s], -16)
+                      .arg(t.prepareNs / 1000.0, 11, 'f', 1)
+                      .arg(t.execCount, 6)
+                      .arg(avgUs, 9, 'f', 1)
+                      .arg(t.maxExecNs / 1000.0, 9, 'f', 1);
+    }
+    return report;
+}
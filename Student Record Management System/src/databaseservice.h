@@ -0,0 +1,83 @@
+#ifndef DATABASESERVICE_H
+#define DATABASESERVICE_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+// One long-lived, tuned SQLite connection. Owned by main() and shared by
+// every MainWindow session; a second thread needs its own instance under
+// another connection name.
+//
+// The statements the windows run are prepared once, on first use, and
+// reused from then on. Prepare and exec times are collected per statement
+// and logged when the service is destroyed (see timingReport()).
+class DatabaseService
+{
+public:
+    // how long a statement waits on another connection's lock before
+    // failing with SQLITE_BUSY; BusyRetry takes over from there
+    static constexpr int BusyTimeoutMs = 2000;
+
+    enum Statement {
+        SelectStudent,   // :r
+        InsertStudent,   // :name, :rollno, :course, :grade
+        UpdateStudent,   // :name, :course, :grade, :roll
+        UpdateStudentIfVersion, // as UpdateStudent, plus :version
+        DeleteStudent,   // :roll
+        InsertTicket,      // :user, :subject, :message, :created
+        ResolveTicket,     // :resolved, :id
+        SelectUserTickets, // :user
+        CountOpenTickets,
+        StatementCount
+    };
+
+    explicit DatabaseService(const QString &connectionName = "students");
+    ~DatabaseService();
+
+    DatabaseService(const DatabaseService &) = delete;
+    DatabaseService &operator=(const DatabaseService &) = delete;
+
+    // opens path, applies the pragmas and migrates the schema. Returns false
+    // only if the database is unusable. Duplicate roll numbers hold back just
+    // the unique rollno index; see duplicateRollNos().
+    bool open(const QString &path);
+    bool isOpen() const { return m_db.isOpen(); }
+
+    QSqlDatabase database() const { return m_db; }
+    QString path() const { return m_db.databaseName(); }
+    QString lastError() const { return m_error; }
+    QStringList duplicateRollNos() const { return m_duplicates; }
+
+    // the cached prepared query, with any previous result released; bind
+    // values on it, then call exec()
+    QSqlQuery &statement(Statement s);
+    bool exec(Statement s);
+
+    // empty until a cached statement has been used
+    QString timingReport() const;
+
+private:
+    struct Timing {
+        qint64 prepareNs = 0;
+        qint64 execCount = 0;
+        qint64 execNs    = 0;
+        qint64 maxExecNs = 0;
+    };
+
+    QString      m_connectionName;
+    QSqlDatabase m_db;
+    QString      m_error;
+    QStringList  m_duplicates;
+
+    std::unique_ptr<QSqlQuery> m_queries[StatementCount];
+    bool   m_prepared[StatementCount] = {};
+    Timing m_timings[StatementCount];
+
+    bool applyPragmas();
+};
+
+#endif // DATABASESERVICE_H
@@ -0,0 +1,273 @@
+#include "dbworker.h"
+#include "databaseservice.h"
+#include "rollnoindex.h"
+
+#include <QSqlQuery>
+#include <QThread>
+#include <QVariant>
+
+namespace {
+
+DbWorker::Reply replyFrom(const StudentRepository::Result &result)
+{
+    DbWorker::Reply reply;
+    reply.ok = result.ok;
+    reply.error = result.error;
+    reply.nativeCode = result.nativeCode;
+    reply.rowsAffected = result.ok ? result.rows : 0;
+    return reply;
+}
+
+QFuture<DbWorker::Reply> finished(const DbWorker::Reply &reply)
+{
+    QPromise<DbWorker::Reply> promise;
+    QFuture<DbWorker::Reply> future = promise.future();
+    promise.start();
+    promise.addResult(reply);
+    promise.finish();
+    return future;
+}
+
+} // namespace
+
+DbWorker::DbWorker(const QString &dbPath, int capacity, qint64 cacheBytes)
+    : m_dbPath(dbPath)
+    , m_capacity(qMax(1, capacity))
+    , m_cache(cacheBytes)
+{
+    m_thread.reset(QThread::create([this]() { run(); }));
+    m_thread->setObjectName("DbWorker");
+    m_thread->start();
+}
+
+DbWorker::~DbWorker()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_stopping = true;
+        m_wake.wakeAll();
+    }
+    cancelPending();
+    m_thread->wait();
+}
+
+int DbWorker::pending() const
+{
+    QMutexLocker lock(&m_mutex);
+    return int(m_queue.size());
+}
+
+StudentCache::Stats DbWorker::cacheStats() const
+{
+    QMutexLocker lock(&m_statsMutex);
+    return m_cacheStats;
+}
+
+void DbWorker::cancelPending()
+{
+    std::deque<std::unique_ptr<Task>> dropped;
+    {
+        QMutexLocker lock(&m_mutex);
+        dropped.swap(m_queue);
+    }
+    Reply reply;
+    reply.cancelled = true;
+    for (auto &task : dropped) {
+        task->promise.addResult(reply);
+        task->promise.finish();
+    }
+}
+
+QFuture<DbWorker::Reply> DbWorker::enqueue(Job job)
+{
+    auto task = std::make_unique<Task>();
+    task->job = std::move(job);
+    QFuture<Reply> future = task->promise.future();
+
+    QMutexLocker lock(&m_mutex);
+    if (m_stopping || int(m_queue.size()) >= m_capacity) {
+        lock.unlock();
+        Reply reply;
+        reply.busy = true;
+        reply.error = "The database is busy; try again.";
+        return finished(reply);
+    }
+    task->promise.start();
+    m_queue.push_back(std::move(task));
+    m_wake.wakeOne();
+    return future;
+}
+
+void DbWorker::run()
+{
+    // the connection belongs to this thread for its whole life
+    DatabaseService service(
+        QString("students-worker-%1").arg(reinterpret_cast<quintptr>(this), 0, 16));
+    const bool open = service.open(m_dbPath);
+    StudentRepository repository(&service);
+
+    while (true) {
+        std::unique_ptr<Task> task;
+        {
+            QMutexLocker lock(&m_mutex);
+            while (m_queue.empty() && !m_stopping)
+                m_wake.wait(&m_mutex);
+            if (m_queue.empty())
+                return;   // stopping
+            task = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        Reply reply;
+        if (task->promise.isCanceled()) {
+            reply.cancelled = true;
+        } else if (!open) {
+            reply.error = service.lastError();
+        } else {
+            reply = m_retry.run([&]() { return task->job(service, repository); });
+            QMutexLocker lock(&m_statsMutex);
+            m_cacheStats = m_cache.stats();
+        }
+        task->promise.addResult(reply);
+        task->promise.finish();
+    }
+}
+
+// data_version moves only when some other connection commits, so our own
+// writes, already applied to the cache, never clear it
+void DbWorker::checkDataVersion(DatabaseService &db)
+{
+    QSqlQuery query(db.database());
+    if (!query.exec("PRAGMA data_version") || !query.next()) {
+        m_cache.invalidate();
+        return;
+    }
+    const qint64 version = query.value(0).toLongLong();
+    if (version != m_dataVersion && m_dataVersion >= 0)
+        m_cache.invalidate();
+    m_dataVersion = version;
+}
+
+// ---------------- requests ----------------
+
+QFuture<DbWorker::Reply> DbWorker::find(const QString &rollNo)
+{
+    return enqueue([this, rollNo](DatabaseService &db, StudentRepository &students) {
+        checkDataVersion(db);
+
+        Reply reply;
+        if (m_cache.lookup(rollNo, reply.record)) {
+            reply.ok = true;
+            reply.found = true;
+            return reply;
+        }
+
+        StudentRecord record;
+        const StudentRepository::Result result = students.get(rollNo, record);
+        reply = replyFrom(result);
+        reply.rowsAffected = 0;
+        if (result.ok && result.rows > 0) {
+            reply.found = true;
+            reply.record = record;
+            m_cache.insert(record);
+        }
+        return reply;
+    });
+}
+
+QFuture<DbWorker::Reply> DbWorker::add(const StudentRecord &student)
+{
+    return enqueue([this, student](DatabaseService &db, StudentRepository &students) {
+        checkDataVersion(db);
+        const StudentRepository::Result result = students.add(student);
+        Reply reply = replyFrom(result);
+        if (result.ok) {
+            reply.record = student;
+            reply.record.version = 1;
+            m_cache.insert(reply.record);
+        }
+        return reply;
+    });
+}
+
+QFuture<DbWorker::Reply> DbWorker::update(const StudentRecord &student)
+{
+    return enqueue([this, student](DatabaseService &db, StudentRepository &students) {
+        checkDataVersion(db);
+        StudentRecord current;
+        const StudentRepository::Result result = students.update(student, &current);
+        Reply reply = replyFrom(result);
+        reply.conflict = result.conflict;
+        if (result.conflict) {
+            reply.found = true;
+            reply.record = current;
+            m_cache.insert(current);
+        } else if (result.ok && result.rows > 0 && student.version > 0) {
+            reply.record = student;
+            reply.record.version = student.version + 1;
+            m_cache.insert(reply.record);
+        } else {
+            m_cache.remove(student.rollNo);   // failed, or the new version is not known
+        }
+        return reply;
+    });
+}
+
+QFuture<DbWorker::Reply> DbWorker::remove(const QString &rollNo)
+{
+    return enqueue([this, rollNo](DatabaseService &, StudentRepository &students) {
+        m_cache.remove(rollNo);
+        return replyFrom(students.remove(rollNo));
+    });
+}
+
+// findMany() skips the cache on the way in and fills it on the way out
+QFuture<DbWorker::Reply> DbWorker::findMany(const QStringList &rollNos)
+{
+    return enqueue([this, rollNos](DatabaseService &db, StudentRepository &students) {
+        checkDataVersion(db);
+        QVector<StudentRecord> records;
+        const StudentRepository::Result result = students.getMany(rollNos, records);
+        Reply reply = replyFrom(result);
+        reply.rowsAffected = 0;
+        if (result.ok) {
+            for (const StudentRecord &record : records)
+                m_cache.insert(record);
+            reply.found = !records.isEmpty();
+            reply.records = std::move(records);
+        }
+        return reply;
+    });
+}
+
+QFuture<DbWorker::Reply> DbWorker::upsertMany(const QVector<StudentRecord> &batch)
+{
+    return enqueue([this, batch](DatabaseService &db, StudentRepository &students) {
+        checkDataVersion(db);
+        // the new versions are not known here, so the next find() rereads
+        for (const StudentRecord &student : batch)
+            m_cache.remove(student.rollNo);
+        return replyFrom(students.upsertMany(batch));
+    });
+}
+
+QFuture<DbWorker::Reply> DbWorker::removeMany(const QStringList &rollNos)
+{
+    return enqueue([this, rollNos](DatabaseService &, StudentRepository &students) {
+        for (const QString &rollNo : rollNos)
+            m_cache.remove(rollNo);
+        return replyFrom(students.deleteMany(rollNos));
+    });
+}
+
+QFuture<DbWorker::Reply> DbWorker::loadRollNoIndex()
+{
+    return enqueue([](DatabaseService &db, StudentRepository &) {
+        Reply reply;
+        auto index = std::make_shared<RollNoIndex>();
+        reply.ok = index->load(db.database(), &reply.error);
+        if (reply.ok)
+            reply.rollNos = std::move(index);
+        return reply;
+    });
+}
@@ -0,0 +1,118 @@
+#ifndef DBWORKER_H
+#define DBWORKER_H
+
+#include <QFuture>
+#include <QMutex>
+#include <QPromise>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "busyretry.h"
+#include "studentcache.h"
+#include "studentrecord.h"
+#include "studentrepository.h"
+
+class DatabaseService;
+class QThread;
+class RollNoIndex;
+
+// Runs student reads and writes on a thread of its own, with its own
+// connection, so a slow or locked database never stalls the caller.
+//
+// Requests go into a queue of at most capacity entries and are answered
+// through QFutures, in order. A request made while the queue is full is
+// not queued: its future is already finished with Reply::busy set, and
+// the caller decides whether to retry. Cancelling a future before the
+// worker reaches it skips the request; one already running completes.
+//
+// The SQL itself is StudentRepository's; the batch calls run in one
+// transaction each. A request that finds the database locked by another
+// process is retried with BusyRetry before it fails. find() answers from a StudentCache when it can.
+// Writes made here update the cache; a change in PRAGMA data_version,
+// meaning another connection or process has committed, empties it.
+class DbWorker
+{
+public:
+    static constexpr int DefaultCapacity = 64;
+
+    struct Reply {
+        bool    ok = false;
+        bool    busy = false;        // queue was full; nothing was done
+        bool    cancelled = false;   // dropped before it ran
+        QString error;               // driver text when !ok
+        QString nativeCode;          // SQLite result code, e.g. "2067"
+        int     rowsAffected = 0;
+        bool    found = false;       // find(): a row came back
+        bool    conflict = false;    // update(): written elsewhere since it was read
+        StudentRecord record;        // find(): the row; add(), update(): the row
+                                     // as stored, or as it is now on a conflict
+        QVector<StudentRecord> records;   // findMany(): the rows found
+        std::shared_ptr<RollNoIndex> rollNos;   // loadRollNoIndex(); the caller's to keep
+    };
+
+    explicit DbWorker(const QString &dbPath, int capacity = DefaultCapacity,
+                      qint64 cacheBytes = StudentCache::DefaultMaxBytes);
+    ~DbWorker();   // drops queued requests and waits for the running one
+
+    DbWorker(const DbWorker &) = delete;
+    DbWorker &operator=(const DbWorker &) = delete;
+
+    QFuture<Reply> find(const QString &rollNo);
+    QFuture<Reply> add(const StudentRecord &student);
+    QFuture<Reply> update(const StudentRecord &student);
+    QFuture<Reply> remove(const QString &rollNo);
+
+    QFuture<Reply> findMany(const QStringList &rollNos);
+    QFuture<Reply> upsertMany(const QVector<StudentRecord> &students);
+    QFuture<Reply> removeMany(const QStringList &rollNos);
+
+    // every roll number, read in one pass, for completing roll numbers
+    QFuture<Reply> loadRollNoIndex();
+
+    // requests waiting, not counting the one running
+    int pending() const;
+
+    // finishes every queued request as cancelled
+    void cancelPending();
+
+    // as of the last finished request
+    StudentCache::Stats cacheStats() const;
+
+private:
+    using Job = std::function<Reply(DatabaseService &, StudentRepository &)>;
+
+    struct Task {
+        Job job;
+        QPromise<Reply> promise;
+    };
+
+    QString m_dbPath;
+    int     m_capacity;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    std::deque<std::unique_ptr<Task>> m_queue;
+    bool m_stopping = false;
+
+    std::unique_ptr<QThread> m_thread;
+
+    // worker thread only
+    StudentCache m_cache;
+    BusyRetry    m_retry;
+    qint64       m_dataVersion = -1;
+
+    mutable QMutex      m_statsMutex;
+    StudentCache::Stats m_cacheStats;
+
+    QFuture<Reply> enqueue(Job job);
+    void run();
+    void checkDataVersion(DatabaseService &db);
+};
+
+#endif // DBWORKER_H
@@ -0,0 +1,207 @@
+#include "keysettablemodel.h"
+
+#include <QDebug>
+#include <QSqlError>
+
+KeysetTableModel::KeysetTableModel(const QSqlDatabase &db, int columnCount, int cachedPages,
+                                   QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_db(db)
+    , m_columnCount(columnCount)
+{
+    m_pages.setMaxCost(cachedPages);
+}
+
+void KeysetTableModel::bindFilter(QSqlQuery &) const
+{
+}
+
+QVariant KeysetTableModel::displayValue(int, const QVariant &value) const
+{
+    return value;
+}
+
+// ---------------- SQL building ----------------
+
+QString KeysetTableModel::whereClause(bool keyed) const
+{
+    QStringList terms = m_listing.filter;
+    if (keyed) {
+        const QString op = m_listing.order == Qt::AscendingOrder ? ">" : "<";
+        QStringList params;
+        for (int i = 0; i < m_listing.keys.size(); ++i)
+            params << QString(":key%1").arg(i);
+        if (m_listing.keys.size() == 1)
+            terms << QString("%1 %2 %3").arg(m_listing.keys.first(), op, params.first());
+        else
+            terms << QString("(%1) %2 (%3)").arg(m_listing.keys.join(", "), op, params.join(", "));
+    }
+    return terms.isEmpty() ? QString() : " WHERE " + terms.join(" AND ");
+}
+
+QString KeysetTableModel::orderClause() const
+{
+    const QString dir = m_listing.order == Qt::AscendingOrder ? " ASC" : " DESC";
+    return " ORDER BY " + m_listing.keys.join(dir + ", ") + dir;
+}
+
+void KeysetTableModel::bindKey(QSqlQuery &query, const Key &key) const
+{
+    // a NULL would make the row-value comparison NULL and end the listing
+    for (int i = 0; i < key.size(); ++i)
+        query.bindValue(QString(":key%1").arg(i),
+                        key.at(i).isNull() ? QVariant(QString("")) : key.at(i));
+}
+
+QSqlQuery &KeysetTableModel::prepared(std::unique_ptr<QSqlQuery> &slot,
+                                      const QString &sql) const
+{
+    if (!slot) {
+        slot = std::make_unique<QSqlQuery>(m_db);
+        slot->setForwardOnly(true);
+        if (!slot->prepare(sql))
+            qWarning() << metaObject()->className() << "prepare failed:"
+                       << slot->lastError().text();
+    } else {
+        slot->finish();
+    }
+    return *slot;
+}
+
+// ---------------- paging ----------------
+
+void KeysetTableModel::refresh()
+{
+    beginResetModel();
+
+    m_listing = listing();
+    m_firstPageQuery.reset();
+    m_nextPageQuery.reset();
+    m_firstKeyQuery.reset();
+    m_nextKeyQuery.reset();
+    m_pages.clear();
+    m_anchors.clear();
+    m_anchors.append(Key());
+    m_rowCount = 0;
+
+    if (m_db.isOpen()) {
+        QSqlQuery count(m_db);
+        count.prepare("SELECT COUNT(*) FROM " + m_listing.table + whereClause(false));
+        bindFilter(count);
+        if (count.exec() && count.next())
+            m_rowCount = count.value(0).toInt();
+        else
+            qWarning() << metaObject()->className() << "count failed:"
+                       << count.lastError().text();
+    }
+
+    endResetModel();
+}
+
+// Walks forward from the deepest known page start, reading only the key
+// columns (meant to be covered by an index), until the start of page is
+// known.
+bool KeysetTableModel::seekAnchor(int page) const
+{
+    const int keyCount = m_listing.keys.size();
+    while (m_anchors.size() <= page) {
+        const int known = m_anchors.size() - 1;
+        const int rows = (page - known) * PageSize;
+        const bool keyed = known > 0;
+
+        QSqlQuery &query = prepared(keyed ? m_nextKeyQuery : m_firstKeyQuery,
+            "SELECT " + m_listing.keys.join(", ") + " FROM " + m_listing.table +
+            whereClause(keyed) + orderClause() + " LIMIT :limit");
+        bindFilter(query);
+        if (keyed)
+            bindKey(query, m_anchors.last());
+        query.bindValue(":limit", rows);
+
+        if (!query.exec()) {
+            qWarning() << metaObject()->className() << "key query failed:"
+                       << query.lastError().text();
+            return false;
+        }
+        int seen = 0;
+        while (query.next()) {
+            if (++seen % PageSize != 0)
+                continue;
+            Key key;
+            for (int k = 0; k < keyCount; ++k)
+                key.append(query.value(k));
+            m_anchors.append(key);
+        }
+        query.finish();
+
+        if (seen < rows)   // ran off the end of the result
+            return m_anchors.size() > page;
+    }
+    return true;
+}
+
+const KeysetTableModel::Page *KeysetTableModel::page(int index) const
+{
+    if (const Page *cached = m_pages.object(index))
+        return cached;
+    if (!seekAnchor(index))
+        return nullptr;
+
+    const QString columns = "SELECT " + m_listing.columns + ", " + m_listing.keys.join(", ") +
+                            " FROM " + m_listing.table;
+    QSqlQuery &query = index == 0
+        ? prepared(m_firstPageQuery, columns + whereClause(false) + orderClause() + " LIMIT :limit")
+        : prepared(m_nextPageQuery, columns + whereClause(true) + orderClause() + " LIMIT :limit");
+    bindFilter(query);
+    if (index > 0)
+        bindKey(query, m_anchors[index]);
+    query.bindValue(":limit", PageSize);
+
+    if (!query.exec()) {
+        qWarning() << metaObject()->className() << "page query failed:"
+                   << query.lastError().text();
+        return nullptr;
+    }
+
+    auto *p = new Page;
+    p->cells.reserve(PageSize * m_columnCount);
+    Key last;
+    while (query.next()) {
+        for (int c = 0; c < m_columnCount; ++c)
+            p->cells.append(displayValue(c, query.value(c)));
+        last.clear();
+        for (int k = 0; k < m_listing.keys.size(); ++k)
+            last.append(query.value(m_columnCount + k));
+        ++p->rows;
+    }
+    query.finish();
+
+    if (p->rows == PageSize && m_anchors.size() == index + 1)
+        m_anchors.append(last);
+
+    m_pages.insert(index, p);   // cost 1; evicts the least recently used
+    return p;
+}
+
+// ---------------- model interface ----------------
+
+int KeysetTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int KeysetTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_columnCount;
+}
+
+QVariant KeysetTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    const Page *p = page(index.row() / PageSize);
+    const int row = index.row() % PageSize;
+    if (!p || row >= p->rows)
+        return QVariant();
+    return p->cells.at(row * m_columnCount + index.column());
+}
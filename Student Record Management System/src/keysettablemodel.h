@@ -0,0 +1,89 @@
+#ifndef KEYSETTABLEMODEL_H
+#define KEYSETTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include <memory>
+
+// Read-only table model over a query too large to load at once.
+//
+// Rows are fetched PageSize at a time when a view asks for them, using
+// keyset pagination: each page starts after the key columns of the
+// previous page's last row, so no query ever uses OFFSET. At most
+// cachedPages pages are held (least recently used go first); besides that
+// only one page-start key per page scrolled past is kept.
+//
+// Subclasses describe what to list in listing(), bind the values of their
+// filter terms in bindFilter() and call refresh() once constructed and
+// whenever the listing changes.
+class KeysetTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int PageSize = 128;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // drops everything cached and recounts, e.g. after an edit
+    void refresh();
+
+protected:
+    // SELECT <columns> FROM <table> WHERE <filter...> ORDER BY <keys...>
+    struct Listing {
+        QString       table;
+        QString       columns;   // columnCount of them, in column order
+        QStringList   filter;    // ANDed terms
+        QStringList   keys;      // sort columns, never NULL; the last unique
+        Qt::SortOrder order = Qt::AscendingOrder;
+    };
+
+    KeysetTableModel(const QSqlDatabase &db, int columnCount, int cachedPages,
+                     QObject *parent = nullptr);
+
+    virtual Listing listing() const = 0;
+    virtual void bindFilter(QSqlQuery &query) const;
+    // what data() shows for a value read from column
+    virtual QVariant displayValue(int column, const QVariant &value) const;
+
+private:
+    using Key = QVariantList;   // one value per key column
+
+    struct Page {
+        QVector<QVariant> cells;   // PageSize x columnCount, row-major
+        int rows = 0;
+    };
+
+    QSqlDatabase m_db;
+    const int    m_columnCount;
+    Listing      m_listing;   // as of the last refresh()
+    int          m_rowCount = 0;
+
+    // rebuilt by refresh(); all lazily prepared
+    mutable std::unique_ptr<QSqlQuery> m_firstPageQuery;
+    mutable std::unique_ptr<QSqlQuery> m_nextPageQuery;
+    mutable std::unique_ptr<QSqlQuery> m_firstKeyQuery;
+    mutable std::unique_ptr<QSqlQuery> m_nextKeyQuery;
+
+    // m_anchors[p] is the last key of page p - 1; m_anchors[0] is unused
+    mutable QVector<Key> m_anchors;
+    mutable QCache<int, Page> m_pages;
+
+    QString whereClause(bool keyed) const;
+    QString orderClause() const;
+    void bindKey(QSqlQuery &query, const Key &key) const;
+    QSqlQuery &prepared(std::unique_ptr<QSqlQuery> &slot, const QString &sql) const;
+
+    bool seekAnchor(int page) const;
+    const Page *page(int index) const;
+};
+
+#endif // KEYSETTABLEMODEL_H
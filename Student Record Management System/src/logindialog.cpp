@@ -1,17 +1,17 @@
 #include "logindialog.h"
+#include "credentialstore.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
-#include <QFile>
-#include <QTextStream>
-#include <QCoreApplication>
+#include <QApplication>
 #include <QMessageBox>
 
-LoginDialog::LoginDialog(QWidget *parent)
+LoginDialog::LoginDialog(CredentialStore *store, QWidget *parent)
     : QDialog(parent)
+    , m_store(store)
 {
     setWindowTitle("Login");
     resize(320, 200);
@@ -46,26 +46,21 @@ LoginDialog::LoginDialog(QWidget *parent)
 
 bool LoginDialog::tryLogin(const QString &user, const QString &pass)
 {
-    QString path = QCoreApplication::applicationDirPath() + "/credentials.txt";
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (m_store->accountCount() == 0 && !m_store->load()) {
         QMessageBox::warning(this, "Error", "credentials.txt missing!");
         return false;
     }
 
-    QTextStream in(&file);
-    QString u, p, r;
-    while (!in.atEnd()) {
-        in >> u >> p >> r;
-        if (u.isEmpty())
-            continue;
-        if (u == user && p == pass) {
-            m_user = u;
-            m_role = r;
-            return true;
-        }
-    }
-    return false;
+    // the hash takes a noticeable moment by design
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const QString role = m_store->authenticate(user, pass);
+    QApplication::restoreOverrideCursor();
+    if (role.isEmpty())
+        return false;
+
+    m_user = user;
+    m_role = role;
+    return true;
 }
 
 void LoginDialog::onLogin()
@@ -5,13 +5,15 @@
 
 class QLineEdit;
 class QPushButton;
+class CredentialStore;
 
 class LoginDialog : public QDialog
 {
     Q_OBJECT
 
 public:
-    explicit LoginDialog(QWidget *parent = nullptr);
+    // store is owned by the caller and outlives the dialog
+    explicit LoginDialog(CredentialStore *store, QWidget *parent = nullptr);
     ~LoginDialog() override = default;
 
     QString currentUser() const { return m_user; }
@@ -26,6 +28,7 @@ private:
     QLineEdit   *m_passEdit;
     QPushButton *m_loginButton;
     QPushButton *m_cancelButton;
+    CredentialStore *m_store;
 
     QString m_user;
     QString m_role;
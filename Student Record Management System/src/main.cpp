@@ -1,8 +1,185 @@
 #include <QApplication>
+#include <QDebug>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QTimer>
+#include <QUrl>
+#include <cstdio>
+#include "backupscheduler.h"
+#include "credentialstore.h"
+#include "databaseservice.h"
 #include "mainwindow.h"
 #include "startdialog.h"
 #include "logindialog.h"
+#include "studentexporter.h"
+#include "studentimporter.h"
+#include "syncclient.h"
+#include "ticketstore.h"
+
+// data/students.db next to the executable
+static QString databasePath()
+{
+    QDir dir(QCoreApplication::applicationDirPath());
+    if (!dir.exists("data")) {
+        dir.mkdir("data");
+    }
+    return dir.filePath("data/students.db");
+}
+
+// data/backups
+static QString backupDirectory()
+{
+    return QFileInfo(databasePath()).dir().filePath("backups");
+}
+
+// StudentRecordManager --import <file.csv>: no windows, summary on stdout
+static int runImport(int argc, char *argv[], const QString &csvPath)
+{
+    QCoreApplication app(argc, argv);
+
+    StudentImporter importer(databasePath(), csvPath);
+    QObject::connect(&importer, &StudentImporter::progress,
+                     [](qint64 done, qint64 total) {
+                         if (total > 0)
+                             std::fprintf(stderr, "\r%3d%%", int(done * 100 / total));
+                     });
+    importer.run();
+    std::fprintf(stderr, "\n");
+
+    const StudentImporter::Result r = importer.result();
+    std::printf("imported %lld, rejected %lld, %.2f s (%.0f rows/s)\n",
+                static_cast<long long>(r.imported),
+                static_cast<long long>(r.rejected), r.seconds,
+                r.seconds > 0 ? (r.imported + r.rejected) / r.seconds : 0.0);
+    if (!r.rejectedReport.isEmpty())
+        std::printf("rejected rows: %s\n", qPrintable(r.rejectedReport));
+    if (!r.error.isEmpty()) {
+        std::fprintf(stderr, "import failed: %s\n", qPrintable(r.error));
+        return 1;
+    }
+    return 0;
+}
+
+// StudentRecordManager --export <file.csv|file.jsonl> [--course C] [--grade G]
+static int runExport(int argc, char *argv[], const QString &outPath)
+{
+    QCoreApplication app(argc, argv);
+
+    QString course;
+    QString grade;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (qstrcmp(argv[i], "--course") == 0)
+            course = QString::fromLocal8Bit(argv[i + 1]);
+        else if (qstrcmp(argv[i], "--grade") == 0)
+            grade = QString::fromLocal8Bit(argv[i + 1]);
+    }
+
+    StudentExporter exporter(databasePath(), outPath,
+                             StudentExporter::formatForPath(outPath), course, grade);
+    exporter.run();
+
+    const StudentExporter::Result r = exporter.result();
+    if (!r.error.isEmpty()) {
+        std::fprintf(stderr, "export failed: %s\n", qPrintable(r.error));
+        return 1;
+    }
+    std::printf("exported %lld, %.2f s (%.0f rows/s)\n",
+                static_cast<long long>(r.exported), r.seconds,
+                r.seconds > 0 ? r.exported / r.seconds : 0.0);
+    return 0;
+}
+
+// StudentRecordManager --sync <server url>: pushes local changes, pulls the rest
+static int runSync(int argc, char *argv[], const QString &server)
+{
+    QCoreApplication app(argc, argv);
+
+    SyncClient client(databasePath(), QUrl::fromUserInput(server));
+    QObject::connect(&client, &SyncClient::finished, &app, &QCoreApplication::quit);
+    QTimer::singleShot(0, &client, &SyncClient::sync);
+    app.exec();
+
+    const SyncClient::Result r = client.result();
+    if (!r.ok) {
+        std::fprintf(stderr, "sync failed: %s\n", qPrintable(r.error));
+        return 1;
+    }
+    std::printf("site %s: pushed %lld (%lld lost to newer changes), pulled %lld, "
+                "kept %lld newer local, %.2f s\n",
+                qPrintable(client.siteId()), static_cast<long long>(r.pushed),
+                static_cast<long long>(r.lost), static_cast<long long>(r.pulled),
+                static_cast<long long>(r.keptLocal), r.seconds);
+    return 0;
+}
+
+// StudentRecordManager --backup [--compress] [--keep N]: one backup now
+static int runBackup(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    DatabaseBackup::Options options;
+    options.dir = backupDirectory();
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--compress") == 0)
+            options.compress = true;
+        else if (i + 1 < argc && qstrcmp(argv[i], "--keep") == 0)
+            options.keep = QByteArray(argv[i + 1]).toInt();
+    }
+
+    DatabaseBackup backup(databasePath(), options);
+    QObject::connect(&backup, &DatabaseBackup::progress, [](qint64 done, qint64 total) {
+        if (total > 0)
+            std::fprintf(stderr, "\r%3d%%", int(done * 100 / total));
+    });
+    backup.run();
+    std::fprintf(stderr, "\n");
+
+    const DatabaseBackup::Result r = backup.result();
+    if (!r.error.isEmpty()) {
+        std::fprintf(stderr, "backup failed: %s\n", qPrintable(r.error));
+        return 1;
+    }
+    std::printf("%s: %.1f MiB copied, %.1f MiB on disk, %.2f s, %d restart(s), verified\n",
+                qPrintable(r.file), r.bytesCopied / 1048576.0, r.fileBytes / 1048576.0,
+                r.seconds, r.restarts);
+    for (const QString &old : r.removed)
+        std::printf("removed %s\n", qPrintable(old));
+    return 0;
+}
+
+// StudentRecordManager --unpack-backup <file.db.qz> <file.db>
+static int runUnpackBackup(int argc, char *argv[], const QString &from, const QString &to)
+{
+    QCoreApplication app(argc, argv);
+
+    QString error;
+    if (!DatabaseBackup::unpack(from, to, &error)) {
+        std::fprintf(stderr, "unpack failed: %s\n", qPrintable(error));
+        return 1;
+    }
+    return 0;
+}
+
+// StudentRecordManager --upgrade-credentials: hashes every plain-text password
+static int runUpgradeCredentials(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    CredentialStore credentials(QCoreApplication::applicationDirPath() + "/credentials.txt");
+    if (!credentials.load()) {
+        std::fprintf(stderr, "%s\n", qPrintable(credentials.lastError()));
+        return 1;
+    }
+    const int upgraded = credentials.upgradeAll();
+    if (upgraded < 0) {
+        std::fprintf(stderr, "%s\n", qPrintable(credentials.lastError()));
+        return 1;
+    }
+    std::printf("%d of %d account(s) hashed\n", upgraded, credentials.accountCount());
+    return 0;
+}
 
 static void loadStyleSheet(QApplication &app)
 {
@@ -16,44 +193,107 @@ static void loadStyleSheet(QApplication &app)
 
 int main(int argc, char *argv[])
 {
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (hasValue && qstrcmp(argv[i], "--import") == 0)
+            return runImport(argc, argv, QString::fromLocal8Bit(argv[i + 1]));
+        if (hasValue && qstrcmp(argv[i], "--export") == 0)
+            return runExport(argc, argv, QString::fromLocal8Bit(argv[i + 1]));
+        if (hasValue && qstrcmp(argv[i], "--sync") == 0)
+            return runSync(argc, argv, QString::fromLocal8Bit(argv[i + 1]));
+        if (qstrcmp(argv[i], "--upgrade-credentials") == 0)
+            return runUpgradeCredentials(argc, argv);
+        if (qstrcmp(argv[i], "--backup") == 0)
+            return runBackup(argc, argv);
+        if (i + 2 < argc && qstrcmp(argv[i], "--unpack-backup") == 0)
+            return runUnpackBackup(argc, argv, QString::fromLocal8Bit(argv[i + 1]),
+                                   QString::fromLocal8Bit(argv[i + 2]));
+    }
+
     QApplication app(argc, argv);
     loadStyleSheet(app);
 
+    // read once and kept current by a file watcher; LoginDialog retries a
+    // missing file on the next attempt
+    CredentialStore credentials(QCoreApplication::applicationDirPath() + "/credentials.txt");
+    credentials.load();
+
+    // one connection for the whole process, shared by every session below
+    DatabaseService db;
+    if (!db.open(databasePath())) {
+        QMessageBox::critical(nullptr, "Database Error",
+                              "Failed to open database:\n" + db.lastError());
+    } else if (!db.duplicateRollNos().isEmpty()) {
+        // the rest of the schema, row versions included, is current; only
+        // the unique rollno index, and with it CSV import and sync, waits
+        QMessageBox::warning(nullptr, "Database Upgrade",
+                             "Roll numbers must be unique, but these are stored "
+                             "more than once:\n\n" + db.duplicateRollNos().join("\n") +
+                             "\n\nDelete or correct the extra records. Until then "
+                             "CSV import and sync are unavailable; the check is "
+                             "retried on the next start.");
+    }
+
+    // tickets.txt from older versions moves into the tickets table once
+    if (db.isOpen()) {
+        TicketStore tickets(&db);
+        if (tickets.importLegacyFile(QCoreApplication::applicationDirPath() + "/tickets.txt") < 0)
+            QMessageBox::warning(nullptr, "Tickets",
+                                 "Could not move tickets.txt into the database:\n" +
+                                 tickets.lastError());
+    }
+
+    // daily, on its own connection and thread; the newest seven are kept
+    DatabaseBackup::Options backupOptions;
+    backupOptions.dir = backupDirectory();
+    BackupScheduler backups(databasePath(), backupOptions);
+    QObject::connect(&backups, &BackupScheduler::backupFinished,
+                     [](const DatabaseBackup::Result &r) {
+                         if (r.error.isEmpty())
+                             qInfo().noquote() << QString("backup %1: %2 bytes copied in %3 s")
+                                                      .arg(r.file).arg(r.bytesCopied)
+                                                      .arg(r.seconds, 0, 'f', 2);
+                         else
+                             qWarning().noquote() << "backup failed:" << r.error;
+                     });
+    if (db.isOpen())
+        backups.start();
+
     while (true) {
         StartDialog start;
         if (start.exec() != QDialog::Accepted)
             break;
 
         if (start.isStudentChoice()) {
-            LoginDialog login;
+            LoginDialog login(&credentials);
             if (login.exec() != QDialog::Accepted)
                 continue;
             if (login.currentRole() != "student")
                 continue;
 
-            MainWindow w;
+            MainWindow w(&db);
             w.setRole("student", login.currentUser());
             if (!w.execMain())
                 break;
         } else if (start.isAdminChoice()) {
-            LoginDialog login;
+            LoginDialog login(&credentials);
             if (login.exec() != QDialog::Accepted)
                 continue;
             if (login.currentRole() != "admin")
                 continue;
 
-            MainWindow w;
+            MainWindow w(&db);
             w.setRole("admin", login.currentUser());
             if (!w.execMain())
                 break;
         } else { // guest
-            LoginDialog login;
+            LoginDialog login(&credentials);
             if (login.exec() != QDialog::Accepted)
                 continue;
             if (login.currentRole() != "guest")
                 continue;
 
-            MainWindow w;
+            MainWindow w(&db);
             w.setRole("guest", login.currentUser());
             if (!w.execMain())
                 break;
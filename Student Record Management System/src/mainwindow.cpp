@@ -1,5 +1,14 @@
 #include "mainwindow.h"
-
+#include "databaseservice.h"
+#include "rollnoindex.h"
+#include "studentexporter.h"
+#include "studentimporter.h"
+#include "studentlistmodel.h"
+#include "studentsearch.h"
+#include "ticketqueuedialog.h"
+
+#include <QAbstractItemView>
+#include <QCompleter>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QLabel>
@@ -7,27 +16,40 @@
 #include <QHBoxLayout>
 #include <QGridLayout>
 #include <QGroupBox>
-#include <QDir>
+#include <QHeaderView>
+#include <QListWidget>
+#include <QTableView>
+#include <QTimer>
 #include <QCoreApplication>
-#include <QSqlQuery>
-#include <QSqlError>
 #include <QMessageBox>
-#include <QFile>
-#include <QTextStream>
 #include <QEventLoop>
-#include <QInputDialog>
-
-MainWindow::MainWindow(QWidget *parent)
+#include <QFileDialog>
+#include <QDialog>
+#include <QProgressDialog>
+#include <QStatusBar>
+#include <QStringListModel>
+#include <QStyle>
+#include <QThread>
+
+MainWindow::MainWindow(DatabaseService *db, QWidget *parent)
     : QMainWindow(parent)
+    , m_db(db)
+    , m_tickets(db)
 {
     setupUi();
-    setupDatabase();
+
+    // student reads and writes; the list, search and tickets read on their own
+    if (m_db->isOpen())
+        m_worker = std::make_unique<DbWorker>(m_db->path());
 }
 
 MainWindow::~MainWindow()
 {
-    if (db.isOpen())
-        db.close();
+    // the searcher is deleted on its own thread once the loop stops
+    if (searchThread) {
+        searchThread->quit();
+        searchThread->wait();
+    }
 }
 
 bool MainWindow::execMain()
@@ -45,7 +67,7 @@ bool MainWindow::execMain()
 void MainWindow::setupUi()
 {
     setWindowTitle("Student Record Manager");
-    resize(900, 540);
+    resize(900, 800);
     setMinimumSize(800, 500);                    // similar compact width[web:125]
 
     QWidget *central = new QWidget(this);
@@ -73,6 +95,21 @@ void MainWindow::setupUi()
     line1->addWidget(viewStudentBtn);
     studentLayout->addLayout(line1);
 
+    // not idInput->setCompleter(): the index does the matching, the
+    // completer only shows what completeRollNo() hands it
+    rollMatches = new QStringListModel(this);
+    rollCompleter = new QCompleter(rollMatches, this);
+    rollCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    rollCompleter->setWidget(idInput);
+
+    // View Details result; feedback goes to the status bar, not message boxes
+    detailsLabel = new QLabel(this);
+    detailsLabel->setAlignment(Qt::AlignCenter);
+    studentLayout->addWidget(detailsLabel);
+
+    cacheLabel = new QLabel(this);
+    statusBar()->addPermanentWidget(cacheLabel);
+
     // Line 2: raise ticket (for student role only)
     QHBoxLayout *line2 = new QHBoxLayout;
     line2->setAlignment(Qt::AlignHCenter);
@@ -139,6 +176,85 @@ void MainWindow::setupUi()
 
     mainLayout->addWidget(formGroup);
 
+    // ---------------- Admin-only student list ----------------
+    browseGroup = new QGroupBox("Admin: All Students", this);
+    QVBoxLayout *browseLayout = new QVBoxLayout(browseGroup);
+    browseLayout->setContentsMargins(10, 10, 10, 10);
+
+    filterEdit = new QLineEdit(browseGroup);
+    filterEdit->setPlaceholderText("Filter by roll no prefix or name");
+    filterEdit->setClearButtonEnabled(true);
+
+    // rows are fetched by the model page by page; fixed row heights keep
+    // the view from measuring every row of a large table
+    studentView = new QTableView(browseGroup);
+    studentView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    studentView->setSelectionMode(QAbstractItemView::SingleSelection);
+    studentView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    studentView->verticalHeader()->hide();
+    studentView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    studentView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    studentView->horizontalHeader()->setSortIndicator(0, Qt::AscendingOrder);
+    studentView->setMinimumHeight(220);
+
+    searchEdit = new QLineEdit(browseGroup);
+    searchEdit->setPlaceholderText("Search names, courses and roll numbers");
+    searchEdit->setClearButtonEnabled(true);
+
+    searchResults = new QListWidget(browseGroup);
+    searchResults->setUniformItemSizes(true);
+    searchResults->setMaximumHeight(160);
+    searchResults->hide();
+
+    searchInfo = new QLabel(browseGroup);
+    searchInfo->hide();
+
+    browseLayout->addWidget(searchEdit);
+    browseLayout->addWidget(searchResults);
+    browseLayout->addWidget(searchInfo);
+    browseLayout->addWidget(filterEdit);
+    browseLayout->addWidget(studentView);
+    mainLayout->addWidget(browseGroup, 1);
+
+    // search runs on its own thread; this only waits out a burst of typing
+    searchTimer = new QTimer(this);
+    searchTimer->setSingleShot(true);
+    searchTimer->setInterval(150);
+    connect(searchEdit, &QLineEdit::textChanged, searchTimer, qOverload<>(&QTimer::start));
+    connect(searchTimer, &QTimer::timeout, this, &MainWindow::startSearch);
+
+    connect(searchResults, &QListWidget::itemClicked, this, [this](QListWidgetItem *item) {
+        const QStringList fields = item->data(Qt::UserRole).toStringList();
+        if (fields.size() != 4)
+            return;
+        idInput->setText(fields.at(0));
+        rollnoEdit->setText(fields.at(0));
+        nameEdit->setText(fields.at(1));
+        courseEdit->setText(fields.at(2));
+        gradeEdit->setText(fields.at(3));
+        fetchIntoForm(fields.at(0));
+    });
+
+    filterTimer = new QTimer(this);
+    filterTimer->setSingleShot(true);
+    filterTimer->setInterval(250);
+    connect(filterEdit, &QLineEdit::textChanged, filterTimer, qOverload<>(&QTimer::start));
+    connect(filterTimer, &QTimer::timeout, this, [this]() {
+        if (studentModel)
+            studentModel->setFilter(filterEdit->text());
+    });
+
+    // picking a row loads it into the admin form
+    connect(studentView, &QTableView::clicked, this, [this](const QModelIndex &index) {
+        const QAbstractItemModel *model = index.model();
+        const int row = index.row();
+        rollnoEdit->setText(model->index(row, StudentListModel::RollNoColumn).data().toString());
+        nameEdit->setText(model->index(row, StudentListModel::NameColumn).data().toString());
+        courseEdit->setText(model->index(row, StudentListModel::CourseColumn).data().toString());
+        gradeEdit->setText(model->index(row, StudentListModel::GradeColumn).data().toString());
+        fetchIntoForm(rollnoEdit->text());
+    });
+
     // ---------------- Buttons row ----------------
     QHBoxLayout *buttonLayout = new QHBoxLayout;
     buttonLayout->setSpacing(12);
@@ -146,11 +262,15 @@ void MainWindow::setupUi()
     addButton    = new QPushButton("Add", this);
     editButton   = new QPushButton("Update", this);
     deleteButton = new QPushButton("Delete", this);
+    importButton = new QPushButton("Import CSV", this);
+    exportButton = new QPushButton("Export", this);
     backButton   = new QPushButton("Back to Main", this);
 
     buttonLayout->addWidget(addButton);
     buttonLayout->addWidget(editButton);
     buttonLayout->addWidget(deleteButton);
+    buttonLayout->addWidget(importButton);
+    buttonLayout->addWidget(exportButton);
     buttonLayout->addStretch();
     buttonLayout->addWidget(backButton);
     mainLayout->addLayout(buttonLayout);
@@ -165,41 +285,21 @@ void MainWindow::setupUi()
     connect(addButton,         &QPushButton::clicked,   this, &MainWindow::addStudent);
     connect(editButton,        &QPushButton::clicked,   this, &MainWindow::editStudent);
     connect(deleteButton,      &QPushButton::clicked,   this, &MainWindow::deleteStudent);
+    connect(importButton,      &QPushButton::clicked,   this, &MainWindow::importStudents);
+    connect(exportButton,      &QPushButton::clicked,   this, &MainWindow::exportStudents);
     connect(ticketButton,      &QPushButton::clicked,   this, &MainWindow::raiseTicket);
     connect(viewTicketsButton, &QPushButton::clicked,   this, &MainWindow::viewTickets);
     connect(backButton,        &QPushButton::clicked,   this, &MainWindow::backToMain);
 
     // View Details: all roles use DB lookup, no table
-    connect(viewStudentBtn, &QPushButton::clicked, this, [this]() {
-        QString roll = idInput->text().trimmed();
-        if (roll.isEmpty()) {
-            QMessageBox::information(this, "Input", "Enter a roll number.");
-            return;
-        }
-
-        if (!db.isOpen())
-            return;
-
-        QSqlQuery query;
-        query.prepare("SELECT name, course, grade FROM students WHERE rollno = :r");
-        query.bindValue(":r", roll);
-        if (!query.exec()) {
-            QMessageBox::warning(this, "Database Error",
-                                 "Failed to load student:\n" + query.lastError().text());
-            return;
-        }
-
-        if (!query.next()) {
-            QMessageBox::information(this, "Not found",
-                                     "No student found with that roll number.");
-            return;
-        }
-
-        QString info = "Name: "   + query.value(0).toString() + "\n" +
-                       "Course: " + query.value(1).toString() + "\n" +
-                       "Grade: "  + query.value(2).toString();
-        QMessageBox::information(this, "Student Details", info);
-    });
+    connect(viewStudentBtn, &QPushButton::clicked, this, &MainWindow::viewStudent);
+    connect(idInput, &QLineEdit::returnPressed, this, &MainWindow::viewStudent);
+    connect(idInput, &QLineEdit::textEdited, this, &MainWindow::completeRollNo);
+    connect(rollCompleter, qOverload<const QString &>(&QCompleter::activated), this,
+            [this](const QString &roll) {
+                idInput->setText(roll);
+                viewStudent();
+            });
 }
 
 void MainWindow::setRole(const QString &roleName, const QString &userName)
@@ -211,24 +311,33 @@ void MainWindow::setRole(const QString &roleName, const QString &userName)
     addButton->setEnabled(false);
     editButton->setEnabled(false);
     deleteButton->setEnabled(false);
+    importButton->setEnabled(false);
+    exportButton->setEnabled(false);
     ticketButton->setEnabled(false);
     viewTicketsButton->setEnabled(false);
     idInput->setEnabled(false);
     viewStudentBtn->setEnabled(false);
+    m_rollNos.reset();
+    rollMatches->setStringList({});
 
     // default: show widgets
     addButton->show();
     editButton->show();
     deleteButton->show();
+    importButton->show();
+    exportButton->show();
     ticketButton->show();
     viewTicketsButton->show();
     formGroup->show();
+    browseGroup->hide();
 
     if (m_role == "admin") {
         // admin: form CRUD + ticket viewer; can also use roll-number view
         addButton->setEnabled(true);
         editButton->setEnabled(true);
         deleteButton->setEnabled(true);
+        importButton->setEnabled(true);
+        exportButton->setEnabled(true);
         viewTicketsButton->setEnabled(true);
 
         ticketButton->hide();          // admin does not raise tickets
@@ -237,6 +346,32 @@ void MainWindow::setRole(const QString &roleName, const QString &userName)
         viewStudentBtn->setEnabled(true);
 
         formGroup->show();
+
+        if (!studentModel && m_db->isOpen()) {
+            studentModel = new StudentListModel(m_db->database(), this);
+            studentView->setModel(studentModel);
+            studentView->setSortingEnabled(true);
+        }
+        if (!searchThread && m_db->isOpen()) {
+            searchThread = new QThread(this);
+            studentSearch = new StudentSearch(m_db->path());
+            studentSearch->moveToThread(searchThread);
+            connect(searchThread, &QThread::finished, studentSearch, &QObject::deleteLater);
+            connect(studentSearch, &StudentSearch::resultsReady, this, &MainWindow::showSearchResults);
+            connect(studentSearch, &StudentSearch::failed, this,
+                    [this](quint64 ticket, const QString &error) {
+                        if (ticket != searchTicket)
+                            return;
+                        searchResults->hide();
+                        searchInfo->setText("Search failed: " + error);
+                        searchInfo->show();
+                    });
+            searchThread->start();
+        }
+        browseGroup->show();
+
+        // completion lists every roll number, so only admins get it
+        loadRollNos();
     } else if (m_role == "student") {
         // student: ID + View + Raise Ticket + View Tickets, no admin form or CRUD
         idInput->setEnabled(true);
@@ -248,6 +383,8 @@ void MainWindow::setRole(const QString &roleName, const QString &userName)
         addButton->hide();
         editButton->hide();
         deleteButton->hide();
+        importButton->hide();
+        exportButton->hide();
     } else if (m_role == "guest") {
         // guest: only ID + View + Back
         idInput->setEnabled(true);
@@ -257,133 +394,269 @@ void MainWindow::setRole(const QString &roleName, const QString &userName)
         addButton->hide();
         editButton->hide();
         deleteButton->hide();
+        importButton->hide();
+        exportButton->hide();
         ticketButton->hide();
         viewTicketsButton->hide();
     }
 }
 
-void MainWindow::setupDatabase()
+void MainWindow::refreshStudentList()
 {
-    QDir dir(QCoreApplication::applicationDirPath());
-    if (!dir.exists("data")) {
-        dir.mkdir("data");
-    }
-    const QString dbPath = dir.filePath("data/students.db");
+    if (studentModel)
+        studentModel->refresh();
+    if (studentSearch && !searchEdit->text().trimmed().isEmpty())
+        startSearch();
+}
+
+// until the index arrives, idInput just has no completions; an add or
+// delete queued behind the load is applied to the new index, not lost
+void MainWindow::loadRollNos()
+{
+    if (!m_worker)
+        return;
+    m_worker->loadRollNoIndex().then(this, [this](const DbWorker::Reply &reply) {
+        if (m_role != "admin")
+            return;
+        if (!reply.ok || !reply.rollNos) {
+            if (!reportUnsent(reply))
+                showStatus("Roll number suggestions are unavailable: " + failureText(reply), true);
+            return;
+        }
+        m_rollNos = reply.rollNos;
+    });
+}
+
+void MainWindow::completeRollNo(const QString &text)
+{
+    if (!m_rollNos)
+        return;
 
-    db = QSqlDatabase::addDatabase("QSQLITE");
-    db.setDatabaseName(dbPath);
+    const QString prefix = text.trimmed();
+    const QStringList matches = m_rollNos->complete(prefix);
+    rollMatches->setStringList(matches);
+    if (matches.isEmpty() || (matches.size() == 1 && matches.first() == prefix))
+        rollCompleter->popup()->hide();
+    else
+        rollCompleter->complete();
+}
 
-    if (!db.open()) {
-        QMessageBox::critical(this, "Database Error",
-                              "Failed to open database:\n" + db.lastError().text());
+void MainWindow::startSearch()
+{
+    if (!studentSearch)
+        return;
+
+    const QString text = searchEdit->text();
+    const quint64 ticket = ++searchTicket;
+    StudentSearch *search = studentSearch;
+    search->supersede(ticket);
+    QMetaObject::invokeMethod(search, [search, ticket, text]() {
+        search->search(ticket, text);
+    }, Qt::QueuedConnection);
+}
+
+void MainWindow::showSearchResults(quint64 ticket, const StudentSearch::Hits &hits, double ms)
+{
+    if (ticket != searchTicket)
+        return;   // an older query finished late
+
+    searchResults->clear();
+    if (searchEdit->text().trimmed().isEmpty()) {
+        searchResults->hide();
+        searchInfo->hide();
         return;
     }
 
-    QSqlQuery query;
-    const QString createSql =
-        "CREATE TABLE IF NOT EXISTS students ("
-        " id INTEGER PRIMARY KEY AUTOINCREMENT,"
-        " name   TEXT NOT NULL,"
-        " rollno TEXT NOT NULL,"
-        " course TEXT,"
-        " grade  TEXT"
-        ")";
-    if (!query.exec(createSql)) {
-        QMessageBox::critical(this, "Database Error",
-                              "Failed to create table:\n" + query.lastError().text());
+    for (const StudentSearch::Hit &hit : hits) {
+        auto *item = new QListWidgetItem(
+            QString("%1  %2  (%3, %4)").arg(hit.rollNo, hit.name, hit.course, hit.grade),
+            searchResults);
+        item->setData(Qt::UserRole, QStringList{ hit.rollNo, hit.name, hit.course, hit.grade });
     }
+    searchResults->setVisible(!hits.isEmpty());
+    searchInfo->setText(hits.isEmpty()
+                            ? QString("No matches (%1 ms)").arg(ms, 0, 'f', 1)
+                            : QString("%1 match(es) in %2 ms").arg(hits.size()).arg(ms, 0, 'f', 1));
+    searchInfo->show();
 }
 
-void MainWindow::addStudent()
+void MainWindow::showStatus(const QString &text, bool error)
+{
+    // errors stay up until the next message; everything else fades
+    statusBar()->setProperty("error", error);
+    statusBar()->style()->unpolish(statusBar());
+    statusBar()->style()->polish(statusBar());
+    statusBar()->showMessage(text, error ? 0 : 6000);
+}
+
+// true if the request was refused before reaching the database
+bool MainWindow::reportUnsent(const DbWorker::Reply &reply)
+{
+    if (reply.cancelled)
+        return true;
+    if (reply.busy) {
+        showStatus(reply.error, true);
+        return true;
+    }
+    return false;
+}
+
+QString MainWindow::failureText(const DbWorker::Reply &reply) const
+{
+    if (BusyRetry::isBusy(reply.nativeCode))
+        return "the database is in use on another workstation; try again in a moment.";
+    return reply.error;
+}
+
+void MainWindow::loadForm(const StudentRecord &student)
+{
+    rollnoEdit->setText(student.rollNo);
+    nameEdit->setText(student.name);
+    courseEdit->setText(student.course);
+    gradeEdit->setText(student.grade);
+    m_formRoll = student.rollNo;
+    m_formVersion = student.version;
+}
+
+// the list and the search results show a row without its version; read
+// it so that an edit from the form can tell if someone else got there first
+void MainWindow::fetchIntoForm(const QString &rollNo)
 {
-    if (m_role != "admin")
+    m_formRoll.clear();
+    m_formVersion = 0;
+    if (!m_worker || rollNo.isEmpty())
         return;
+    m_worker->find(rollNo).then(this, [this, rollNo](const DbWorker::Reply &reply) {
+        if (reply.ok && reply.found && rollnoEdit->text().trimmed() == rollNo)
+            loadForm(reply.record);
+    });
+}
 
-    const QString name   = nameEdit->text().trimmed();
-    const QString rollno = rollnoEdit->text().trimmed();
-    const QString course = courseEdit->text().trimmed();
-    const QString grade  = gradeEdit->text().trimmed();
+void MainWindow::updateCacheLabel()
+{
+    const StudentCache::Stats s = m_worker->cacheStats();
+    cacheLabel->setText(QString("Lookup cache: %1% hits, %2 records, %3 KiB")
+                            .arg(qRound(s.hitRatio() * 100))
+                            .arg(s.entries)
+                            .arg((s.bytes + 1023) / 1024));
+    cacheLabel->setToolTip(QString("%1 hits, %2 misses, %3 time(s) cleared after "
+                                   "changes from elsewhere")
+                               .arg(s.hits).arg(s.misses).arg(s.invalidations));
+}
 
-    if (name.isEmpty() || rollno.isEmpty() || course.isEmpty() || grade.isEmpty()) {
-        QMessageBox::information(this, "Validation",
-                                 "Please fill all fields before adding.");
+void MainWindow::addStudent()
+{
+    if (m_role != "admin" || !m_worker)
         return;
-    }
 
-    QSqlQuery query;
-    query.prepare(
-        "INSERT INTO students (name, rollno, course, grade) "
-        "VALUES (:name, :rollno, :course, :grade)");
-    query.bindValue(":name",   name);
-    query.bindValue(":rollno", rollno);
-    query.bindValue(":course", course);
-    query.bindValue(":grade",  grade);
-
-    if (!query.exec()) {
-        QMessageBox::warning(this, "Database Error",
-                             "Failed to add student:\n" + query.lastError().text());
+    const StudentRecord student{ nameEdit->text().trimmed(), rollnoEdit->text().trimmed(),
+                                 courseEdit->text().trimmed(), gradeEdit->text().trimmed() };
+
+    if (student.name.isEmpty() || student.rollNo.isEmpty() ||
+        student.course.isEmpty() || student.grade.isEmpty()) {
+        showStatus("Please fill all fields before adding.", true);
         return;
     }
 
-    QMessageBox::information(this, "Success", "Student added to database.");
+    showStatus("Adding " + student.rollNo + "...");
+    m_worker->add(student).then(this, [this, student](const DbWorker::Reply &reply) {
+        if (reportUnsent(reply))
+            return;
+        if (!reply.ok) {
+            // SQLITE_CONSTRAINT(_UNIQUE): idx_students_rollno; the other
+            // constraint (NOT NULL) is ruled out by the checks above
+            if (reply.nativeCode == "2067" || reply.nativeCode == "19")
+                showStatus("A student with Roll No " + student.rollNo + " already exists.", true);
+            else
+                showStatus("Failed to add student: " + failureText(reply), true);
+            return;
+        }
 
-    nameEdit->clear();
-    rollnoEdit->clear();
-    courseEdit->clear();
-    gradeEdit->clear();
+        showStatus("Student " + student.rollNo + " added.");
+        refreshStudentList();
+        if (m_rollNos)
+            m_rollNos->insert(student.rollNo);
+
+        // leave the form alone if the user has started on the next student
+        if (rollnoEdit->text().trimmed() == student.rollNo) {
+            nameEdit->clear();
+            rollnoEdit->clear();
+            courseEdit->clear();
+            gradeEdit->clear();
+        }
+    });
 }
 
 void MainWindow::editStudent()
 {
-    if (m_role != "admin")
+    if (m_role != "admin" || !m_worker)
         return;
 
-    const QString rollno = rollnoEdit->text().trimmed();
-    const QString name   = nameEdit->text().trimmed();
-    const QString course = courseEdit->text().trimmed();
-    const QString grade  = gradeEdit->text().trimmed();
+    const StudentRecord student{ nameEdit->text().trimmed(), rollnoEdit->text().trimmed(),
+                                 courseEdit->text().trimmed(), gradeEdit->text().trimmed() };
 
-    if (rollno.isEmpty()) {
-        QMessageBox::information(this, "Update Student",
-                                 "Enter Roll No to update.");
+    if (student.rollNo.isEmpty()) {
+        showStatus("Enter Roll No to update.", true);
         return;
     }
 
-    QSqlQuery query;
-    query.prepare(
-        "UPDATE students "
-        "SET name = :name, course = :course, grade = :grade "
-        "WHERE rollno = :roll");
-    query.bindValue(":name",   name);
-    query.bindValue(":course", course);
-    query.bindValue(":grade",  grade);
-    query.bindValue(":roll",   rollno);
-
-    if (!query.exec()) {
-        QMessageBox::warning(this, "Database Error",
-                             "Failed to update student:\n" + query.lastError().text());
-        return;
-    }
+    // checked against the version the form was loaded at, if it was
+    StudentRecord edited = student;
+    if (student.rollNo == m_formRoll)
+        edited.version = m_formVersion;
+    sendUpdate(edited);
+}
 
-    if (query.numRowsAffected() == 0) {
-        QMessageBox::information(this, "Update Student",
-                                 "No student found with that Roll No.");
-    } else {
-        QMessageBox::information(this, "Update Student",
-                                 "Student record updated.");
-    }
+void MainWindow::sendUpdate(const StudentRecord &student)
+{
+    showStatus("Updating " + student.rollNo + "...");
+    m_worker->update(student).then(this, [this, student](const DbWorker::Reply &reply) {
+        if (reportUnsent(reply))
+            return;
+        if (!reply.ok) {
+            showStatus("Failed to update student: " + failureText(reply), true);
+            return;
+        }
+        if (reply.conflict) {
+            const StudentRecord &now = reply.record;
+            const auto answer = QMessageBox::question(
+                this, "Student Changed",
+                "Roll No " + student.rollNo + " was changed by someone else after you "
+                "loaded it. It now reads:\n\n"
+                "Name: " + now.name + "\nCourse: " + now.course + "\nGrade: " + now.grade +
+                "\n\nSave your changes over theirs?");
+            if (answer == QMessageBox::Yes) {
+                StudentRecord retry = student;
+                retry.version = now.version;
+                sendUpdate(retry);
+            } else {
+                loadForm(now);
+                showStatus("The form now shows the current record for " + student.rollNo + ".");
+            }
+            return;
+        }
+        if (reply.rowsAffected == 0) {
+            showStatus("No student found with Roll No " + student.rollNo + ".", true);
+            return;
+        }
+        if (reply.record.version > 0 && rollnoEdit->text().trimmed() == student.rollNo) {
+            m_formRoll = student.rollNo;
+            m_formVersion = reply.record.version;
+        }
+        showStatus("Student " + student.rollNo + " updated.");
+        refreshStudentList();
+    });
 }
 
 void MainWindow::deleteStudent()
 {
-    if (m_role != "admin")
+    if (m_role != "admin" || !m_worker)
         return;
 
     const QString rollno = rollnoEdit->text().trimmed();
 
     if (rollno.isEmpty()) {
-        QMessageBox::information(this, "Delete Student",
-                                 "Enter the Roll No of the student to delete.");
+        showStatus("Enter the Roll No of the student to delete.", true);
         return;
     }
 
@@ -395,25 +668,218 @@ void MainWindow::deleteStudent()
     if (reply != QMessageBox::Yes)
         return;
 
-    QSqlQuery query;
-    query.prepare("DELETE FROM students WHERE rollno = :roll");
-    query.bindValue(":roll", rollno);
+    showStatus("Deleting " + rollno + "...");
+    m_worker->remove(rollno).then(this, [this, rollno](const DbWorker::Reply &reply) {
+        if (reportUnsent(reply))
+            return;
+        if (!reply.ok) {
+            showStatus("Failed to delete student: " + failureText(reply), true);
+            return;
+        }
+        if (reply.rowsAffected == 0) {
+            showStatus("No student found with Roll No " + rollno + ".", true);
+            return;
+        }
+        showStatus("Student " + rollno + " deleted.");
+        refreshStudentList();
+        if (m_rollNos)
+            m_rollNos->remove(rollno);
+        if (m_formRoll == rollno)
+            m_formRoll.clear();
+
+        if (rollnoEdit->text().trimmed() == rollno)
+            rollnoEdit->clear();
+    });
+}
 
-    if (!query.exec()) {
-        QMessageBox::warning(this, "Database Error",
-                             "Failed to delete student:\n" + query.lastError().text());
+void MainWindow::viewStudent()
+{
+    const QString roll = idInput->text().trimmed();
+    if (roll.isEmpty()) {
+        showStatus("Enter a roll number.", true);
         return;
     }
+    if (!m_worker)
+        return;
+
+    // only the newest lookup is worth waiting for
+    m_lookup.cancel();
+    detailsLabel->clear();
+    m_lookup = m_worker->find(roll);
+    m_lookup.then(this, [this, roll](const DbWorker::Reply &reply) {
+        if (reportUnsent(reply))
+            return;
+        if (!reply.ok) {
+            showStatus("Failed to load student: " + failureText(reply), true);
+            return;
+        }
+        updateCacheLabel();
+        if (!reply.found) {
+            showStatus("No student found with roll number " + roll + ".", true);
+            return;
+        }
+        detailsLabel->setText("Name: "     + reply.record.name +
+                              "    Course: " + reply.record.course +
+                              "    Grade: "  + reply.record.grade);
+        statusBar()->clearMessage();
+    });
+}
+
+void MainWindow::importStudents()
+{
+    if (m_role != "admin" || !m_db->isOpen())
+        return;
+
+    const QString csvPath = QFileDialog::getOpenFileName(
+        this, "Import Students", QString(), "CSV files (*.csv);;All files (*)");
+    if (csvPath.isEmpty())
+        return;
 
-    if (query.numRowsAffected() == 0) {
-        QMessageBox::information(this, "Delete Student",
-                                 "No student found with that Roll No.");
-    } else {
-        QMessageBox::information(this, "Delete Student",
-                                 "Student record(s) deleted.");
+    // the importer opens its own connection on the worker thread
+    QThread thread;
+    StudentImporter importer(m_db->path(), csvPath);
+    importer.moveToThread(&thread);
+
+    QProgressDialog progress("Importing students...", "Cancel", 0, 1000, this);
+    progress.setWindowTitle("Import CSV");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.setValue(0);
+
+    QEventLoop loop;
+    connect(&thread, &QThread::started, &importer, &StudentImporter::run);
+    connect(&importer, &StudentImporter::progress, &progress,
+            [&progress](qint64 done, qint64 total) {
+                progress.setValue(total > 0 ? int(done * 1000 / total) : 0);
+            });
+    // direct: the worker is busy inside run() and would never see a queued call
+    connect(&progress, &QProgressDialog::canceled, this,
+            [&importer]() { importer.cancel(); }, Qt::DirectConnection);
+    connect(&importer, &StudentImporter::finished, &loop, &QEventLoop::quit);
+
+    thread.start();
+    loop.exec();
+    thread.quit();
+    thread.wait();
+    progress.reset();
+
+    const StudentImporter::Result r = importer.result();
+    refreshStudentList();
+    if (r.imported > 0)
+        loadRollNos();
+
+    if (!r.error.isEmpty()) {
+        QMessageBox::warning(this, "Import CSV",
+                             QString("Import stopped after %1 student(s):\n%2")
+                                 .arg(r.imported).arg(r.error));
+        return;
     }
 
-    rollnoEdit->clear();
+    QString summary = QString("%1 student(s) imported in %2 s")
+                          .arg(r.imported)
+                          .arg(r.seconds, 0, 'f', 1);
+    if (r.cancelled)
+        summary += " before cancelling";
+    summary += ".";
+    if (r.rejected > 0) {
+        summary += QString("\n\n%1 row(s) rejected; see\n%2")
+                       .arg(r.rejected).arg(r.rejectedReport);
+    }
+    QMessageBox::information(this, "Import CSV", summary);
+}
+
+void MainWindow::exportStudents()
+{
+    if (m_role != "admin" || !m_db->isOpen())
+        return;
+
+    QDialog dlg(this);
+    dlg.setWindowTitle("Export Students");
+
+    QVBoxLayout *layout = new QVBoxLayout(&dlg);
+    layout->setContentsMargins(20, 20, 20, 20);
+    layout->setSpacing(12);
+
+    QLabel *title = new QLabel("Leave a field empty to export every value", &dlg);
+
+    QLineEdit *courseFilter = new QLineEdit(&dlg);
+    courseFilter->setPlaceholderText("Course (optional)");
+
+    QLineEdit *gradeFilter = new QLineEdit(&dlg);
+    gradeFilter->setPlaceholderText("Grade (optional)");
+
+    QHBoxLayout *btnLayout = new QHBoxLayout;
+    QPushButton *okBtn = new QPushButton("Export...", &dlg);
+    QPushButton *cancelBtn = new QPushButton("Cancel", &dlg);
+    btnLayout->addStretch();
+    btnLayout->addWidget(okBtn);
+    btnLayout->addWidget(cancelBtn);
+
+    layout->addWidget(title);
+    layout->addWidget(courseFilter);
+    layout->addWidget(gradeFilter);
+    layout->addLayout(btnLayout);
+
+    connect(okBtn,     &QPushButton::clicked, &dlg, &QDialog::accept);
+    connect(cancelBtn, &QPushButton::clicked, &dlg, &QDialog::reject);
+
+    if (dlg.exec() != QDialog::Accepted)
+        return;
+
+    QString selectedFilter;
+    const QString outPath = QFileDialog::getSaveFileName(
+        this, "Export Students", "students.csv",
+        "CSV files (*.csv);;JSON Lines (*.jsonl)", &selectedFilter);
+    if (outPath.isEmpty())
+        return;
+    const StudentExporter::Format format =
+        selectedFilter.startsWith("JSON") ? StudentExporter::JsonLines
+                                          : StudentExporter::formatForPath(outPath);
+
+    // the exporter opens its own connection on the worker thread
+    QThread thread;
+    StudentExporter exporter(m_db->path(), outPath, format,
+                             courseFilter->text().trimmed(),
+                             gradeFilter->text().trimmed());
+    exporter.moveToThread(&thread);
+
+    QProgressDialog progress("Exporting students...", "Cancel", 0, 1000, this);
+    progress.setWindowTitle("Export");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.setValue(0);
+
+    QEventLoop loop;
+    connect(&thread, &QThread::started, &exporter, &StudentExporter::run);
+    connect(&exporter, &StudentExporter::progress, &progress,
+            [&progress](qint64 done, qint64 total) {
+                progress.setValue(total > 0 ? int(done * 1000 / total) : 0);
+            });
+    // direct: the worker is busy inside run() and would never see a queued call
+    connect(&progress, &QProgressDialog::canceled, this,
+            [&exporter]() { exporter.cancel(); }, Qt::DirectConnection);
+    connect(&exporter, &StudentExporter::finished, &loop, &QEventLoop::quit);
+
+    thread.start();
+    loop.exec();
+    thread.quit();
+    thread.wait();
+    progress.reset();
+
+    const StudentExporter::Result r = exporter.result();
+    if (!r.error.isEmpty()) {
+        QMessageBox::warning(this, "Export", "Export failed:\n" + r.error);
+        return;
+    }
+    if (r.cancelled) {
+        QMessageBox::information(this, "Export", "Export cancelled; no file was written.");
+        return;
+    }
+    QMessageBox::information(this, "Export",
+                             QString("%1 student(s) exported in %2 s to\n%3")
+                                 .arg(r.exported)
+                                 .arg(r.seconds, 0, 'f', 1)
+                                 .arg(outPath));
 }
 
 void MainWindow::raiseTicket()
@@ -470,87 +936,22 @@ void MainWindow::raiseTicket()
         return;
     }
 
-    QString path = QCoreApplication::applicationDirPath() + "/tickets.txt";
-    QFile file(path);
-    if (!file.open(QIODevice::Append | QIODevice::Text)) {
-        QMessageBox::warning(this, "Tickets", "Cannot open tickets.txt");
+    const qint64 id = m_tickets.raise(m_user, subject, message);
+    if (id < 0) {
+        QMessageBox::warning(this, "Tickets",
+                             "Cannot save the ticket:\n" + m_tickets.lastError());
         return;
     }
 
-    static int nextId = 1;
-    QTextStream out(&file);
-    out << nextId++ << ' ' << m_user << ' '
-        << subject.simplified() << ' '
-        << message.simplified() << " open\n";
-
-    QMessageBox::information(this, "Tickets", "Ticket submitted.");
+    QMessageBox::information(this, "Tickets",
+                             QString("Ticket %1 submitted.").arg(id));
 }
 
 void MainWindow::viewTickets()
 {
-    QString path = QCoreApplication::applicationDirPath() + "/tickets.txt";
-
     if (m_role == "admin") {
-        QFile file(path);
-        if (!file.exists()) {
-            QMessageBox::information(this, "Tickets", "No tickets found.");
-            return;
-        }
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QMessageBox::warning(this, "Tickets", "Cannot open tickets.txt");
-            return;
-        }
-
-        QTextStream in(&file);
-        QStringList lines;
-        while (!in.atEnd())
-            lines << in.readLine();
-        file.close();
-
-        if (lines.isEmpty()) {
-            QMessageBox::information(this, "Tickets", "No tickets found.");
-            return;
-        }
-
-        // Show all tickets with indices so admin can type 0, 1, ...
-        QString all;
-        for (int i = 0; i < lines.size(); ++i)
-            all += QString::number(i) + ": " + lines[i] + "\n";
-
-        bool ok = false;
-        int idx = QInputDialog::getInt(
-            this,
-            "Tickets",
-            "Tickets:\n\n" + all +
-            "\nEnter index (e.g. 0 or 1) to mark as resolved (-1 to cancel):",
-            -1, -1, lines.size() - 1, 1, &ok
-        );
-        if (!ok || idx < 0)
-            return;
-
-        QString line = lines[idx];
-        // expect format: id user subject issue status
-        QStringList parts = line.split(' ');
-        if (parts.size() >= 4) {
-            if (parts.size() == 4) {
-                parts << "cleared";
-            } else {
-                parts[4] = "cleared";
-            }
-            line = parts.join(' ');
-            lines[idx] = line;
-
-            if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
-                QMessageBox::warning(this, "Tickets", "Cannot update tickets.txt");
-                return;
-            }
-            QTextStream out(&file);
-            for (const QString &l : lines)
-                out << l << '\n';
-            file.close();
-        }
-
-        QMessageBox::information(this, "Tickets", "Ticket marked as issue resolved.");
+        TicketQueueDialog queue(m_db, this);
+        queue.exec();
         return;
     }
 
@@ -560,47 +961,19 @@ void MainWindow::viewTickets()
         return;
     }
 
-    QFile file(path);
-    if (!file.exists()) {
-        QMessageBox::information(this, "Tickets", "No ticket has been raised.");
-        return;
-    }
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Tickets", "Cannot open tickets.txt");
-        return;
-    }
-
-    QTextStream in(&file);
-    QStringList lines;
-    while (!in.atEnd()) {
-        const QString line = in.readLine().trimmed();
-        if (line.isEmpty())
-            continue;
-        const QStringList parts = line.split(' ');
-        if (parts.size() < 4)
-            continue;
-        if (parts[1] == m_user)
-            lines << line;
-    }
-    file.close();
-
-    if (lines.isEmpty()) {
+    const QVector<TicketStore::Ticket> mine = m_tickets.ticketsFor(m_user);
+    if (mine.isEmpty()) {
         QMessageBox::information(this, "Tickets", "No ticket has been raised.");
         return;
     }
 
     QString details;
-    for (const QString &l : lines) {
-        const QStringList p = l.split(' ');
-        QString id    = p[0];
-        QString subj  = p[2];
-        QString issue = p[3];
-        QString status = (p.size() > 4 ? p[4] : "open");
-
-        details += "Ticket ID: " + id + "\n";
-        details += "Subject: " + subj + "\n";
-        details += "Issue: " + issue + "\n";
-        details += "Status: " + status + "\n\n";
+    for (const TicketStore::Ticket &t : mine) {
+        details += "Ticket ID: " + QString::number(t.id) + "\n";
+        details += "Raised: " + t.createdAt.toString("yyyy-MM-dd hh:mm") + "\n";
+        details += "Subject: " + t.subject + "\n";
+        details += "Issue: " + t.message + "\n";
+        details += "Status: " + t.status + "\n\n";
     }
 
     QMessageBox::information(this, "Your Tickets", details);
@@ -1,19 +1,36 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QFuture>
 #include <QMainWindow>
-#include <QSqlDatabase>
 
+#include <memory>
+
+#include "dbworker.h"
+#include "studentsearch.h"
+#include "ticketstore.h"
+
+class QCompleter;
+class QLabel;
 class QLineEdit;
+class QListWidget;
 class QPushButton;
+class QStringListModel;
 class QGroupBox;
+class QTableView;
+class QThread;
+class QTimer;
+class DatabaseService;
+class RollNoIndex;
+class StudentListModel;
 
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
 
 public:
-    explicit MainWindow(QWidget *parent = nullptr);
+    // db is owned by the caller and outlives the window
+    explicit MainWindow(DatabaseService *db, QWidget *parent = nullptr);
     ~MainWindow() override;
 
     // roleName: "admin", "student", "guest"
@@ -24,16 +41,24 @@ public:
     bool execMain();
 
 private slots:
+    void viewStudent();
+    void completeRollNo(const QString &text);
     void addStudent();
     void editStudent();
     void deleteStudent();
+    void importStudents();
+    void exportStudents();
     void raiseTicket();
     void viewTickets();
     void backToMain();
+    void startSearch();
+    void showSearchResults(quint64 ticket, const StudentSearch::Hits &hits, double ms);
 
 private:
     // widgets
     QLineEdit    *idInput;         // top "Enter Roll No" input
+    QCompleter   *rollCompleter;   // on idInput, fed from m_rollNos
+    QStringListModel *rollMatches;
     QLineEdit    *nameEdit;
     QLineEdit    *rollnoEdit;
     QLineEdit    *courseEdit;
@@ -41,20 +66,50 @@ private:
     QPushButton  *addButton;
     QPushButton  *editButton;
     QPushButton  *deleteButton;
+    QPushButton  *importButton;
+    QPushButton  *exportButton;
     QPushButton  *ticketButton;
     QPushButton  *viewTicketsButton;
     QPushButton  *backButton;
     QPushButton  *viewStudentBtn;  // for all roles
+    QLabel       *detailsLabel;    // result of View Details
+    QLabel       *cacheLabel;      // lookup cache stats, in the status bar
     QGroupBox    *formGroup;       // admin form group
+    QGroupBox    *browseGroup;     // admin student list
+    QLineEdit    *filterEdit;
+    QTableView   *studentView;
+    QTimer       *filterTimer;     // debounces filterEdit
+    StudentListModel *studentModel = nullptr;   // admin only
+    QLineEdit    *searchEdit;
+    QListWidget  *searchResults;
+    QLabel       *searchInfo;
+    QTimer       *searchTimer;     // debounces searchEdit
+    QThread      *searchThread = nullptr;        // admin only
+    StudentSearch *studentSearch = nullptr;      // lives on searchThread
+    quint64      searchTicket = 0;
 
     // db & state
-    QSqlDatabase db;
+    DatabaseService *m_db;
+    TicketStore  m_tickets;
+    std::unique_ptr<DbWorker> m_worker;
+    QFuture<DbWorker::Reply>  m_lookup;   // latest View Details request
+    std::shared_ptr<RollNoIndex> m_rollNos;   // admin only; null until loaded
+    QString      m_formRoll;          // row the admin form was loaded from
+    qint64       m_formVersion = 0;   // and its version then; 0 if not known
     QString      m_role;
     QString      m_user;
     bool         m_backToMain = false;
 
     void setupUi();
-    void setupDatabase();
+    void showStatus(const QString &text, bool error = false);
+    bool reportUnsent(const DbWorker::Reply &reply);
+    QString failureText(const DbWorker::Reply &reply) const;
+    void loadForm(const StudentRecord &student);
+    void fetchIntoForm(const QString &rollNo);
+    void sendUpdate(const StudentRecord &student);
+    void updateCacheLabel();
+    void refreshStudentList();
+    void loadRollNos();
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,156 @@
+#include "rollnoindex.h"
+
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+void RollNoIndex::clear()
+{
+    m_arena.clear();
+    m_offsets.clear();
+    m_deadBytes = 0;
+}
+
+qint64 RollNoIndex::bytesUsed() const
+{
+    return qint64(m_arena.capacity()) + qint64(m_offsets.capacity() * sizeof(uint32_t));
+}
+
+bool RollNoIndex::store(const QByteArray &key, uint32_t &offset)
+{
+    // offsets are 32-bit; four gigabytes of roll numbers is not a real table
+    if (m_arena.size() + size_t(key.size()) + 1 > std::numeric_limits<uint32_t>::max())
+        return false;
+    offset = uint32_t(m_arena.size());
+    m_arena.insert(m_arena.end(), key.constData(), key.constData() + key.size() + 1);
+    return true;
+}
+
+bool RollNoIndex::load(const QSqlDatabase &db, QString *error)
+{
+    clear();
+
+    // idx_students_rollno hands the rows over already sorted
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT rollno FROM students ORDER BY rollno")) {
+        if (error)
+            *error = query.lastError().text();
+        return false;
+    }
+
+    while (query.next()) {
+        const QByteArray key = query.value(0).toString().toUtf8();
+        if (key.isEmpty() || key.contains('\0'))
+            continue;
+        if (!m_offsets.empty()) {
+            const int order = std::strcmp(at(m_offsets.size() - 1), key.constData());
+            if (order == 0)
+                continue;
+            if (order > 0) {
+                // not BINARY order after all; insert() keeps it sorted
+                insert(QString::fromUtf8(key));
+                continue;
+            }
+        }
+        uint32_t offset = 0;
+        if (!store(key, offset)) {
+            clear();
+            if (error)
+                *error = "Too many roll numbers to index.";
+            return false;
+        }
+        m_offsets.push_back(offset);
+    }
+    if (query.lastError().isValid()) {
+        clear();
+        if (error)
+            *error = query.lastError().text();
+        return false;
+    }
+
+    m_arena.shrink_to_fit();
+    m_offsets.shrink_to_fit();
+    return true;
+}
+
+std::vector<uint32_t>::const_iterator RollNoIndex::lowerBound(const QByteArray &key) const
+{
+    return std::lower_bound(m_offsets.begin(), m_offsets.end(), key,
+                            [this](uint32_t offset, const QByteArray &k) {
+                                return std::strcmp(m_arena.data() + offset, k.constData()) < 0;
+                            });
+}
+
+bool RollNoIndex::contains(const QString &rollNo) const
+{
+    const QByteArray key = rollNo.toUtf8();
+    const auto it = lowerBound(key);
+    return it != m_offsets.end() && std::strcmp(m_arena.data() + *it, key.constData()) == 0;
+}
+
+// the string goes on the end of the arena; only its offset is placed in order
+bool RollNoIndex::insert(const QString &rollNo)
+{
+    const QByteArray key = rollNo.toUtf8();
+    if (key.isEmpty() || key.contains('\0'))
+        return false;
+    const auto it = lowerBound(key);
+    if (it != m_offsets.end() && std::strcmp(m_arena.data() + *it, key.constData()) == 0)
+        return false;
+
+    uint32_t offset = 0;
+    if (!store(key, offset))
+        return false;
+    m_offsets.insert(it, offset);
+    return true;
+}
+
+bool RollNoIndex::remove(const QString &rollNo)
+{
+    const QByteArray key = rollNo.toUtf8();
+    const auto it = lowerBound(key);
+    if (it == m_offsets.end() || std::strcmp(m_arena.data() + *it, key.constData()) != 0)
+        return false;
+
+    m_offsets.erase(it);
+    m_deadBytes += size_t(key.size()) + 1;
+    if (m_deadBytes > 4096 && m_deadBytes > m_arena.size() / 2)
+        compact();
+    return true;
+}
+
+// rewrites the arena in roll number order, dropping removed strings
+void RollNoIndex::compact()
+{
+    std::vector<char> arena;
+    arena.reserve(m_arena.size() - m_deadBytes);
+    for (uint32_t &offset : m_offsets) {
+        const char *s = m_arena.data() + offset;
+        offset = uint32_t(arena.size());
+        arena.insert(arena.end(), s, s + std::strlen(s) + 1);
+    }
+    m_arena.swap(arena);
+    m_deadBytes = 0;
+}
+
+QStringList RollNoIndex::complete(const QString &prefix, int limit) const
+{
+    QStringList matches;
+    const QByteArray key = prefix.toUtf8();
+    if (key.isEmpty() || limit <= 0)
+        return matches;
+
+    for (auto it = lowerBound(key); it != m_offsets.end() && matches.size() < limit; ++it) {
+        const char *s = m_arena.data() + *it;
+        if (std::strncmp(s, key.constData(), size_t(key.size())) != 0)
+            break;
+        matches.append(QString::fromUtf8(s));
+    }
+    return matches;
+}
@@ -0,0 +1,59 @@
+#ifndef ROLLNOINDEX_H
+#define ROLLNOINDEX_H
+
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+#include <vector>
+
+class QSqlDatabase;
+
+// Every roll number in memory, sorted, for completing what has been typed
+// so far. The UTF-8 strings sit back to back, NUL-terminated, in one
+// arena; a sorted array of 32-bit offsets into it is binary-searched for
+// the first roll number with the prefix and the matches follow it. About
+// length + 5 bytes per roll number and no allocation per string.
+//
+// insert() appends to the arena and shifts the offsets after it, some
+// tens of microseconds at a million entries; remove() leaves its string
+// in the arena until removed strings fill half of it, then compacts.
+// Roll numbers compare bytewise, as SQLite's BINARY collation does, so
+// matching is case-sensitive. Not thread-safe; build it anywhere, then use
+// it from one thread.
+class RollNoIndex
+{
+public:
+    static constexpr int DefaultLimit = 10;
+
+    // replaces the contents with SELECT rollno ... ORDER BY rollno, read
+    // forward-only; on failure the index is left empty
+    bool load(const QSqlDatabase &db, QString *error = nullptr);
+
+    // false if already present (insert) or absent (remove)
+    bool insert(const QString &rollNo);
+    bool remove(const QString &rollNo);
+    bool contains(const QString &rollNo) const;
+
+    // up to limit roll numbers starting with prefix, in order; none for
+    // an empty prefix
+    QStringList complete(const QString &prefix, int limit = DefaultLimit) const;
+
+    int size() const { return int(m_offsets.size()); }
+    void clear();
+
+    // allocated, including removed strings not yet compacted away
+    qint64 bytesUsed() const;
+
+private:
+    std::vector<char>     m_arena;
+    std::vector<uint32_t> m_offsets;   // into m_arena, in roll number order
+    size_t                m_deadBytes = 0;
+
+    const char *at(size_t i) const { return m_arena.data() + m_offsets[i]; }
+    std::vector<uint32_t>::const_iterator lowerBound(const QByteArray &key) const;
+    bool store(const QByteArray &key, uint32_t &offset);
+    void compact();
+};
+
+#endif // ROLLNOINDEX_H
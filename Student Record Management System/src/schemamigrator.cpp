@@ -0,0 +1,300 @@
+#include "schemamigrator.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include <iterator>
+
+// Append new steps at the end; never edit or reorder a shipped one.
+const SchemaMigrator::Step SchemaMigrator::s_steps[] = {
+    { 1, "create students table",           &SchemaMigrator::createStudents },
+    { 2, "unique index on students.rollno", &SchemaMigrator::uniqueRollNo   },
+    { 3, "course/grade lookup index",       &SchemaMigrator::lookupIndexes  },
+    { 4, "student list sort indexes",       &SchemaMigrator::sortIndexes    },
+    { 5, "full-text search index",          &SchemaMigrator::searchIndex    },
+    { 6, "create tickets table",            &SchemaMigrator::createTickets  },
+    { 7, "ticket queue status index",       &SchemaMigrator::ticketQueue    },
+    { 8, "students row version",            &SchemaMigrator::rowVersions    },
+    { 9, "change log for sync",             &SchemaMigrator::changeLog      },
+    {10, "blank course/grade as ''",        &SchemaMigrator::blankSortKeys  },
+};
+
+SchemaMigrator::SchemaMigrator(const QSqlDatabase &db)
+    : m_db(db)
+{
+}
+
+int SchemaMigrator::latestVersion()
+{
+    return s_steps[std::size(s_steps) - 1].version;
+}
+
+int SchemaMigrator::currentVersion() const
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("PRAGMA user_version") || !query.next())
+        return -1;
+    return query.value(0).toInt();
+}
+
+bool SchemaMigrator::exec(const QString &sql)
+{
+    QSqlQuery query(m_db);
+    if (!query.exec(sql)) {
+        m_error = query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool SchemaMigrator::migrate()
+{
+    m_error.clear();
+    m_duplicates.clear();
+
+    const int from = currentVersion();
+    if (from < 0) {
+        m_error = "Cannot read schema version.";
+        return false;
+    }
+    if (from > latestVersion()) {
+        m_error = QString("Database schema version %1 is newer than this "
+                          "program supports (%2).").arg(from).arg(latestVersion());
+        return false;
+    }
+
+    for (const Step &step : s_steps) {
+        if (step.version <= from)
+            continue;
+
+        if (!m_db.transaction()) {
+            m_error = m_db.lastError().text();
+            return false;
+        }
+        // PRAGMA user_version is transactional, so the bump commits or
+        // rolls back with the step itself
+        if (!(this->*step.apply)() ||
+            !exec(QString("PRAGMA user_version = %1").arg(step.version))) {
+            m_error = QString("Migration to version %1 (%2) failed: %3")
+                          .arg(step.version).arg(step.description, m_error);
+            m_db.rollback();
+            return false;
+        }
+        if (!m_db.commit()) {
+            m_error = m_db.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+    }
+
+    // step 2 leaves the index out while roll numbers are duplicated, so
+    // nothing after it waits on an admin; it is retried on every open
+    if (from >= 2 && !hasIndex("idx_students_rollno")) {
+        if (!m_db.transaction()) {
+            m_error = m_db.lastError().text();
+            return false;
+        }
+        if (!uniqueRollNo()) {
+            m_error = "Unique index on students.rollno failed: " + m_error;
+            m_db.rollback();
+            return false;
+        }
+        if (!m_db.commit()) {
+            m_error = m_db.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SchemaMigrator::hasIndex(const QString &name) const
+{
+    QSqlQuery query(m_db);
+    query.prepare("SELECT 1 FROM sqlite_master WHERE type = 'index' AND name = :name");
+    query.bindValue(":name", name);
+    return query.exec() && query.next();
+}
+
+// ---------------- steps ----------------
+
+bool SchemaMigrator::createStudents()
+{
+    // databases created before versioning already have this table
+    return exec(
+        "CREATE TABLE IF NOT EXISTS students ("
+        " id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        " name   TEXT NOT NULL,"
+        " rollno TEXT NOT NULL,"
+        " course TEXT,"
+        " grade  TEXT"
+        ")");
+}
+
+bool SchemaMigrator::uniqueRollNo()
+{
+    // duplicates are reported for an admin to resolve, never dropped here;
+    // until then the step succeeds without the index (see migrate())
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT rollno, COUNT(*) FROM students "
+                    "GROUP BY rollno HAVING COUNT(*) > 1 ORDER BY rollno")) {
+        m_error = query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        m_duplicates << QString("%1 (%2 records)")
+                            .arg(query.value(0).toString())
+                            .arg(query.value(1).toInt());
+    }
+    if (!m_duplicates.isEmpty())
+        return true;
+
+    return exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_students_rollno "
+                "ON students(rollno)");
+}
+
+bool SchemaMigrator::lookupIndexes()
+{
+    // covers course/grade filters that only need the roll number back
+    return exec("CREATE INDEX IF NOT EXISTS idx_students_course_grade "
+                "ON students(course, grade, rollno)");
+}
+
+bool SchemaMigrator::sortIndexes()
+{
+    // StudentListModel pages with row values like (course, rollno) > (?, ?),
+    // which never match a NULL, so blank course/grade are stored as ''
+    return exec("UPDATE students SET course = '' WHERE course IS NULL")
+        && exec("UPDATE students SET grade = '' WHERE grade IS NULL")
+        && exec("CREATE INDEX IF NOT EXISTS idx_students_name_sort "
+                "ON students(name, rollno)")
+        && exec("CREATE INDEX IF NOT EXISTS idx_students_course_sort "
+                "ON students(course, rollno)")
+        && exec("CREATE INDEX IF NOT EXISTS idx_students_grade_sort "
+                "ON students(grade, rollno)");
+}
+
+bool SchemaMigrator::searchIndex()
+{
+    // external-content FTS5 index over students; the text lives only in
+    // students and the triggers keep the index in step with it
+    QSqlQuery query(m_db);
+    if (!query.exec("CREATE VIRTUAL TABLE IF NOT EXISTS students_fts USING fts5("
+                    " name, course, rollno,"
+                    " content='students', content_rowid='id',"
+                    " tokenize='unicode61 remove_diacritics 2', prefix='1 2 3')")) {
+        // an SQLite built without FTS5: StudentSearch falls back to LIKE
+        if (query.lastError().text().contains("no such module"))
+            return true;
+        m_error = query.lastError().text();
+        return false;
+    }
+
+    return exec("CREATE TRIGGER IF NOT EXISTS students_fts_insert AFTER INSERT ON students BEGIN"
+                " INSERT INTO students_fts(rowid, name, course, rollno)"
+                " VALUES (new.id, new.name, new.course, new.rollno);"
+                " END")
+        && exec("CREATE TRIGGER IF NOT EXISTS students_fts_delete AFTER DELETE ON students BEGIN"
+                " INSERT INTO students_fts(students_fts, rowid, name, course, rollno)"
+                " VALUES ('delete', old.id, old.name, old.course, old.rollno);"
+                " END")
+        && exec("CREATE TRIGGER IF NOT EXISTS students_fts_update"
+                " AFTER UPDATE OF name, course, rollno ON students BEGIN"
+                " INSERT INTO students_fts(students_fts, rowid, name, course, rollno)"
+                " VALUES ('delete', old.id, old.name, old.course, old.rollno);"
+                " INSERT INTO students_fts(rowid, name, course, rollno)"
+                " VALUES (new.id, new.name, new.course, new.rollno);"
+                " END")
+        && exec("INSERT INTO students_fts(students_fts) VALUES ('rebuild')");
+}
+
+bool SchemaMigrator::createTickets()
+{
+    // created_at / resolved_at are Unix seconds
+    return exec("CREATE TABLE IF NOT EXISTS tickets ("
+                " id INTEGER PRIMARY KEY AUTOINCREMENT,"
+                " user        TEXT NOT NULL,"
+                " subject     TEXT NOT NULL,"
+                " message     TEXT NOT NULL DEFAULT '',"
+                " status      TEXT NOT NULL DEFAULT 'open',"
+                " created_at  INTEGER NOT NULL,"
+                " resolved_at INTEGER"
+                ")")
+        && exec("CREATE INDEX IF NOT EXISTS idx_tickets_user_status "
+                "ON tickets(user, status)")
+        && exec("CREATE INDEX IF NOT EXISTS idx_tickets_created "
+                "ON tickets(created_at)");
+}
+
+bool SchemaMigrator::ticketQueue()
+{
+    // rows come out in id order per status, which is what
+    // TicketListModel pages on, and the open count is a covering scan
+    return exec("CREATE INDEX IF NOT EXISTS idx_tickets_status "
+                "ON tickets(status)");
+}
+
+bool SchemaMigrator::rowVersions()
+{
+    // bumped by every update, so an edit made against an older read can be
+    // told apart from one made against the current row
+    return exec("ALTER TABLE students ADD COLUMN version INTEGER NOT NULL DEFAULT 1");
+}
+
+// milliseconds since the epoch, as SQL
+#define NOW_MS "CAST((julianday('now') - 2440587.5) * 86400000 AS INTEGER)"
+
+bool SchemaMigrator::changeLog()
+{
+    // one row per roll number ever written, holding its latest change;
+    // seq only grows, so SyncClient finds what it has not pushed yet with
+    // a range scan on the key. origin is 'remote' for rows SyncClient
+    // applied from the server, which are never pushed back.
+    return exec("CREATE TABLE IF NOT EXISTS change_log ("
+                " seq        INTEGER PRIMARY KEY AUTOINCREMENT,"
+                " rollno     TEXT NOT NULL UNIQUE,"
+                " deleted    INTEGER NOT NULL DEFAULT 0,"
+                " changed_at INTEGER NOT NULL,"
+                " origin     TEXT NOT NULL DEFAULT 'local'"
+                ")")
+        && exec("CREATE TABLE IF NOT EXISTS sync_state ("
+                " key   TEXT PRIMARY KEY,"
+                " value TEXT NOT NULL"
+                ") WITHOUT ROWID")
+        && exec("INSERT OR IGNORE INTO sync_state (key, value) VALUES"
+                " ('site', lower(hex(randomblob(8)))),"
+                " ('pushed_seq', '0'),"
+                " ('pulled_seq', '0')")
+        && exec("CREATE TRIGGER IF NOT EXISTS change_log_insert AFTER INSERT ON students BEGIN"
+                " DELETE FROM change_log WHERE rollno = new.rollno;"
+                " INSERT INTO change_log (rollno, deleted, changed_at)"
+                " VALUES (new.rollno, 0, " NOW_MS ");"
+                " END")
+        && exec("CREATE TRIGGER IF NOT EXISTS change_log_update"
+                " AFTER UPDATE OF name, course, grade, rollno ON students BEGIN"
+                " DELETE FROM change_log WHERE rollno IN (old.rollno, new.rollno);"
+                " INSERT INTO change_log (rollno, deleted, changed_at)"
+                " SELECT old.rollno, 1, " NOW_MS " WHERE old.rollno <> new.rollno;"
+                " INSERT INTO change_log (rollno, deleted, changed_at)"
+                " VALUES (new.rollno, 0, " NOW_MS ");"
+                " END")
+        && exec("CREATE TRIGGER IF NOT EXISTS change_log_delete AFTER DELETE ON students BEGIN"
+                " DELETE FROM change_log WHERE rollno = old.rollno;"
+                " INSERT INTO change_log (rollno, deleted, changed_at)"
+                " VALUES (old.rollno, 1, " NOW_MS ");"
+                " END")
+        // what is already here has never been synced
+        && exec("INSERT OR IGNORE INTO change_log (rollno, deleted, changed_at)"
+                " SELECT rollno, 0, " NOW_MS " FROM students ORDER BY id");
+}
+
+#undef NOW_MS
+
+bool SchemaMigrator::blankSortKeys()
+{
+    // step 4's rule, for NULLs that the CSV import and sync wrote before
+    // they bound blanks as ''; the change log picks the rows up as edits
+    return exec("UPDATE students SET course = '' WHERE course IS NULL")
+        && exec("UPDATE students SET grade = '' WHERE grade IS NULL");
+}
@@ -0,0 +1,57 @@
+#ifndef SCHEMAMIGRATOR_H
+#define SCHEMAMIGRATOR_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+// Upgrades the database schema in place. The schema version lives in
+// PRAGMA user_version; every migration step runs in its own transaction
+// together with the version bump, so a failed step leaves the database
+// at the previous version.
+class SchemaMigrator
+{
+public:
+    explicit SchemaMigrator(const QSqlDatabase &db);
+
+    // runs every step newer than the stored version, then retries the
+    // unique rollno index if duplicates held it back; false on failure
+    bool migrate();
+
+    int currentVersion() const;
+    static int latestVersion();
+
+    QString lastError() const { return m_error; }
+
+    // roll numbers stored more than once; filled when the unique index
+    // on rollno could not be built. The rest of the schema is current.
+    QStringList duplicateRollNos() const { return m_duplicates; }
+
+private:
+    struct Step {
+        int version;
+        const char *description;
+        bool (SchemaMigrator::*apply)();
+    };
+    static const Step s_steps[];
+
+    QSqlDatabase m_db;
+    QString      m_error;
+    QStringList  m_duplicates;
+
+    bool exec(const QString &sql);
+    bool hasIndex(const QString &name) const;
+
+    bool createStudents();
+    bool uniqueRollNo();
+    bool lookupIndexes();
+    bool sortIndexes();
+    bool searchIndex();
+    bool createTickets();
+    bool ticketQueue();
+    bool rowVersions();
+    bool changeLog();
+    bool blankSortKeys();
+};
+
+#endif // SCHEMAMIGRATOR_H
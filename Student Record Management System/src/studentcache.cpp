@@ -0,0 +1,54 @@
+#include "studentcache.h"
+
+StudentCache::StudentCache(qint64 maxBytes)
+{
+    m_cache.setMaxCost(maxBytes);
+}
+
+// the record, its key, the string payloads and QCache's node; close
+// enough to bound the cache, not an exact heap count
+qint64 StudentCache::footprint(const StudentRecord &record)
+{
+    const qint64 chars = record.name.size() + record.rollNo.size() * 2 +
+                         record.course.size() + record.grade.size();
+    return qint64(sizeof(StudentRecord)) + qint64(sizeof(QString)) +
+           chars * qint64(sizeof(QChar)) + 5 * 16 + 64;
+}
+
+bool StudentCache::lookup(const QString &rollNo, StudentRecord &out)
+{
+    if (const StudentRecord *cached = m_cache.object(rollNo)) {
+        ++m_stats.hits;
+        out = *cached;
+        return true;
+    }
+    ++m_stats.misses;
+    return false;
+}
+
+void StudentCache::insert(const StudentRecord &record)
+{
+    // QCache takes ownership, and drops the object if it can never fit
+    m_cache.insert(record.rollNo, new StudentRecord(record), footprint(record));
+}
+
+void StudentCache::remove(const QString &rollNo)
+{
+    m_cache.remove(rollNo);
+}
+
+void StudentCache::invalidate()
+{
+    if (m_cache.isEmpty())
+        return;
+    m_cache.clear();
+    ++m_stats.invalidations;
+}
+
+StudentCache::Stats StudentCache::stats() const
+{
+    Stats s = m_stats;
+    s.entries = m_cache.size();
+    s.bytes = m_cache.totalCost();
+    return s;
+}
@@ -0,0 +1,50 @@
+#ifndef STUDENTCACHE_H
+#define STUDENTCACHE_H
+
+#include <QCache>
+#include <QString>
+
+#include "studentrecord.h"
+
+// Least-recently-used cache of student records keyed by roll number,
+// bounded by an estimate of the memory the entries use. Not thread-safe;
+// DbWorker keeps one on its thread.
+class StudentCache
+{
+public:
+    static constexpr qint64 DefaultMaxBytes = 1 << 20;
+
+    struct Stats {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 invalidations = 0;   // whole-cache clears
+        int    entries = 0;
+        qint64 bytes = 0;
+
+        double hitRatio() const {
+            const qint64 lookups = hits + misses;
+            return lookups ? double(hits) / double(lookups) : 0.0;
+        }
+    };
+
+    explicit StudentCache(qint64 maxBytes = DefaultMaxBytes);
+
+    // copies the record into out on a hit
+    bool lookup(const QString &rollNo, StudentRecord &out);
+
+    void insert(const StudentRecord &record);
+    void remove(const QString &rollNo);
+
+    // everything may be stale, e.g. another connection wrote
+    void invalidate();
+
+    Stats stats() const;
+
+private:
+    QCache<QString, StudentRecord> m_cache;   // cost = estimated bytes
+    Stats m_stats;
+
+    static qint64 footprint(const StudentRecord &record);
+};
+
+#endif // STUDENTCACHE_H
@@ -0,0 +1,223 @@
+#include "studentexporter.h"
+#include "databaseservice.h"
+
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+namespace {
+
+enum Column { NameColumn, RollNoColumn, CourseColumn, GradeColumn, ColumnCount };
+
+const char *const ColumnNames[ColumnCount] = { "name", "rollno", "course", "grade" };
+
+void appendCsv(QByteArray &out, const QByteArray &text)
+{
+    bool quote = false;
+    for (char ch : text) {
+        if (ch == '"' || ch == ',' || ch == '\n' || ch == '\r') {
+            quote = true;
+            break;
+        }
+    }
+    if (!quote) {
+        out += text;
+        return;
+    }
+    out += '"';
+    for (char ch : text) {
+        if (ch == '"')
+            out += '"';
+        out += ch;
+    }
+    out += '"';
+}
+
+void appendJsonString(QByteArray &out, const QByteArray &text)
+{
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (char ch : text) {
+        const unsigned char u = static_cast<unsigned char>(ch);
+        switch (ch) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n";  break;
+        case '\r': out += "\\r";  break;
+        case '\t': out += "\\t";  break;
+        default:
+            if (u < 0x20) {
+                out += "\\u00";
+                out += hex[u >> 4];
+                out += hex[u & 0xf];
+            } else {
+                out += ch;   // UTF-8 passes through
+            }
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+StudentExporter::StudentExporter(const QString &dbPath, const QString &outPath,
+                                 Format format, const QString &course,
+                                 const QString &grade, QObject *parent)
+    : QObject(parent)
+    , m_dbPath(dbPath)
+    , m_outPath(outPath)
+    , m_format(format)
+    , m_course(course)
+    , m_grade(grade)
+{
+}
+
+StudentExporter::Format StudentExporter::formatForPath(const QString &path)
+{
+    return path.endsWith(".jsonl", Qt::CaseInsensitive) ||
+                   path.endsWith(".ndjson", Qt::CaseInsensitive)
+               ? JsonLines
+               : Csv;
+}
+
+void StudentExporter::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_result = Result();
+    m_cancel.store(false);
+
+    // connection names are per thread and per exporter
+    const QString connectionName =
+        QString("students-export-%1").arg(reinterpret_cast<quintptr>(this), 0, 16);
+    exportFrom(connectionName);
+
+    m_result.seconds = timer.nsecsElapsed() / 1e9;
+    emit finished();
+}
+
+bool StudentExporter::exportFrom(const QString &connectionName)
+{
+    DatabaseService service(connectionName);
+    if (!service.open(m_dbPath)) {
+        m_result.error = service.lastError();
+        return false;
+    }
+    QSqlDatabase db = service.database();
+
+    QString where;
+    if (!m_course.isEmpty())
+        where += " WHERE course = :course";
+    if (!m_grade.isEmpty())
+        where += where.isEmpty() ? " WHERE grade = :grade" : " AND grade = :grade";
+    auto bindFilter = [this](QSqlQuery &q) {
+        if (!m_course.isEmpty())
+            q.bindValue(":course", m_course);
+        if (!m_grade.isEmpty())
+            q.bindValue(":grade", m_grade);
+    };
+
+    // one read transaction, so the count and the rows see the same snapshot
+    db.transaction();
+
+    qint64 total = 0;
+    {
+        QSqlQuery count(db);
+        count.setForwardOnly(true);
+        count.prepare("SELECT COUNT(*) FROM students" + where);
+        bindFilter(count);
+        if (count.exec() && count.next())
+            total = count.value(0).toLongLong();
+    }
+
+    // rollno order comes straight off the unique index
+    QSqlQuery rows(db);
+    rows.setForwardOnly(true);
+    if (!rows.prepare("SELECT name, rollno, course, grade FROM students" + where +
+                      " ORDER BY rollno")) {
+        m_result.error = rows.lastError().text();
+        db.rollback();
+        return false;
+    }
+    bindFilter(rows);
+    if (!rows.exec()) {
+        m_result.error = rows.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    QSaveFile out(m_outPath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        m_result.error = "Cannot write " + m_outPath + ": " + out.errorString();
+        db.rollback();
+        return false;
+    }
+
+    QByteArray buffer;
+    buffer.reserve(BufferBytes + 4096);
+    auto drain = [&]() -> bool {
+        if (out.write(buffer) != buffer.size()) {
+            m_result.error = "Cannot write " + m_outPath + ": " + out.errorString();
+            return false;
+        }
+        buffer.resize(0);   // keeps the capacity
+        return true;
+    };
+
+    if (m_format == Csv)
+        buffer += "name,rollno,course,grade\n";
+
+    bool ok = true;
+    qint64 written = 0;
+    while (rows.next()) {
+        if (m_format == Csv) {
+            for (int c = 0; c < ColumnCount; ++c) {
+                if (c)
+                    buffer += ',';
+                appendCsv(buffer, rows.value(c).toString().toUtf8());
+            }
+            buffer += '\n';
+        } else {
+            for (int c = 0; c < ColumnCount; ++c) {
+                buffer += c ? ",\"" : "{\"";
+                buffer += ColumnNames[c];
+                buffer += "\":";
+                appendJsonString(buffer, rows.value(c).toString().toUtf8());
+            }
+            buffer += "}\n";
+        }
+        ++written;
+
+        if (buffer.size() >= BufferBytes && !drain()) {
+            ok = false;
+            break;
+        }
+        if (written % 16384 == 0) {
+            emit progress(written, total);
+            if (m_cancel.load(std::memory_order_relaxed)) {
+                m_result.cancelled = true;
+                break;
+            }
+        }
+    }
+    if (ok && !m_result.cancelled && rows.lastError().isValid()) {
+        m_result.error = rows.lastError().text();
+        ok = false;
+    }
+    rows.finish();
+    db.rollback();   // read-only; nothing to keep
+
+    if (!ok || m_result.cancelled || !drain()) {
+        out.cancelWriting();
+        return false;
+    }
+    if (!out.commit()) {
+        m_result.error = "Cannot write " + m_outPath + ": " + out.errorString();
+        return false;
+    }
+    m_result.exported = written;
+    emit progress(written, written);
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef STUDENTEXPORTER_H
+#define STUDENTEXPORTER_H
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+
+// Streams the students table, optionally narrowed to one course and/or
+// grade, into a CSV or JSON Lines file.
+//
+// Rows come from a forward-only query and are encoded straight into a
+// fixed-size write buffer, so memory use does not grow with the table.
+// The file is written through QSaveFile: it only replaces the target once
+// the export has finished, and a failed or cancelled export leaves any
+// existing file untouched.
+//
+// run() opens its own connection, so the exporter can be moved to a
+// worker thread; cancel() may be called from any thread.
+class StudentExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format { Csv, JsonLines };
+
+    static constexpr int BufferBytes = 1 << 20;
+
+    struct Result {
+        qint64  exported = 0;
+        bool    cancelled = false;
+        double  seconds = 0.0;
+        QString error;          // empty on success
+    };
+
+    // empty course / grade: no filter on that column
+    StudentExporter(const QString &dbPath, const QString &outPath, Format format,
+                    const QString &course = QString(), const QString &grade = QString(),
+                    QObject *parent = nullptr);
+
+    // .jsonl / .ndjson are JSON Lines, anything else CSV
+    static Format formatForPath(const QString &path);
+
+    void cancel() { m_cancel.store(true); }
+    Result result() const { return m_result; }
+
+public slots:
+    void run();
+
+signals:
+    void progress(qint64 rowsWritten, qint64 rowsTotal);
+    void finished();
+
+private:
+    QString m_dbPath;
+    QString m_outPath;
+    Format  m_format;
+    QString m_course;
+    QString m_grade;
+    Result  m_result;
+    std::atomic<bool> m_cancel{false};
+
+    bool exportFrom(const QString &connectionName);
+};
+
+#endif // STUDENTEXPORTER_H
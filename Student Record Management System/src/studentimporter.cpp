@@ -0,0 +1,289 @@
+#include "studentimporter.h"
+#include "databaseservice.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+#include <QVector>
+
+namespace {
+
+enum Field { NameField, RollNoField, CourseField, GradeField, FieldCount };
+
+const int MaxRollNoLength = 32;
+
+// Reads one CSV record into fields. Quoted fields may contain commas,
+// doubled quotes and line breaks; lineNo is advanced past every physical
+// line consumed. Returns false at end of file.
+bool readRecord(QFile &in, QVector<QByteArray> &fields, qint64 &lineNo, QByteArray &raw)
+{
+    fields.clear();
+    raw = in.readLine();
+    if (raw.isEmpty())
+        return false;
+    ++lineNo;
+
+    QByteArray field;
+    bool quoted = false;
+    int i = 0;
+    while (true) {
+        if (i == raw.size()) {
+            if (!quoted)
+                break;
+            // line break inside quotes: the record continues
+            const QByteArray more = in.readLine();
+            if (more.isEmpty())
+                break;   // unterminated quote; keep what we have
+            ++lineNo;
+            raw += more;
+        }
+        const char ch = raw.at(i++);
+        if (quoted) {
+            if (ch == '"') {
+                if (i < raw.size() && raw.at(i) == '"') {
+                    field += '"';
+                    ++i;
+                } else {
+                    quoted = false;
+                }
+            } else {
+                field += ch;
+            }
+        } else if (ch == '"') {
+            quoted = true;
+        } else if (ch == ',') {
+            fields.append(field);
+            field.clear();
+        } else if (ch != '\r' && ch != '\n') {
+            field += ch;
+        }
+    }
+    fields.append(field);
+
+    while (raw.endsWith('\n') || raw.endsWith('\r'))
+        raw.chop(1);
+    return true;
+}
+
+QByteArray csvQuote(const QByteArray &text)
+{
+    QByteArray out = text;
+    out.replace('"', "\"\"");
+    return '"' + out + '"';
+}
+
+} // namespace
+
+StudentImporter::StudentImporter(const QString &dbPath, const QString &csvPath,
+                                 QObject *parent)
+    : QObject(parent)
+    , m_dbPath(dbPath)
+    , m_csvPath(csvPath)
+{
+}
+
+void StudentImporter::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_result = Result();
+    m_cancel.store(false);
+
+    // connection names are per thread and per importer
+    const QString connectionName =
+        QString("students-import-%1").arg(reinterpret_cast<quintptr>(this), 0, 16);
+    importInto(connectionName);
+
+    m_result.seconds = timer.nsecsElapsed() / 1e9;
+    emit finished();
+}
+
+bool StudentImporter::importInto(const QString &connectionName)
+{
+    QFile in(m_csvPath);
+    if (!in.open(QIODevice::ReadOnly)) {
+        m_result.error = "Cannot open " + m_csvPath + ": " + in.errorString();
+        return false;
+    }
+    const qint64 total = in.size();
+
+    DatabaseService service(connectionName);
+    if (!service.open(m_dbPath)) {
+        m_result.error = service.lastError();
+        return false;
+    }
+    if (!service.duplicateRollNos().isEmpty()) {
+        // ON CONFLICT(rollno) needs the unique index
+        m_result.error = "Roll numbers in the database are not unique yet; "
+                         "fix the duplicates before importing.";
+        return false;
+    }
+    QSqlDatabase db = service.database();
+
+    QFile rejectFile(m_csvPath + ".rejected.csv");
+    auto reject = [&](qint64 line, const char *reason, const QByteArray &raw) {
+        if (!rejectFile.isOpen()) {
+            if (!rejectFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+                return;
+            rejectFile.write("line,reason,record\n");
+            m_result.rejectedReport = rejectFile.fileName();
+        }
+        rejectFile.write(QByteArray::number(line) + ',' + reason + ',' + csvQuote(raw) + '\n');
+        ++m_result.rejected;
+    };
+
+    QVector<QByteArray> fields;
+    fields.reserve(8);
+    QByteArray raw;
+    qint64 lineNo = 0;
+    qint64 recordLine = 0;
+
+    // header row, or the default column order
+    int column[FieldCount] = { NameField, RollNoField, CourseField, GradeField };
+    bool haveRecord = readRecord(in, fields, lineNo, raw);
+    if (haveRecord && !fields.isEmpty() && fields[0].startsWith("\xEF\xBB\xBF"))
+        fields[0].remove(0, 3);   // UTF-8 BOM
+    if (haveRecord) {
+        int found[FieldCount] = { -1, -1, -1, -1 };
+        for (int i = 0; i < fields.size(); ++i) {
+            const QByteArray name = fields[i].trimmed().toLower().replace(" ", "").replace("_", "");
+            if (name == "name")                         found[NameField] = i;
+            else if (name == "rollno" || name == "roll") found[RollNoField] = i;
+            else if (name == "course")                  found[CourseField] = i;
+            else if (name == "grade")                   found[GradeField] = i;
+        }
+        if (found[NameField] >= 0 && found[RollNoField] >= 0) {
+            for (int f = 0; f < FieldCount; ++f)
+                column[f] = found[f];
+            haveRecord = readRecord(in, fields, lineNo, raw);
+        }
+    }
+
+    QSqlQuery fullBatch(db);
+    if (!fullBatch.prepare(StudentRepository::upsertSql(RowsPerStatement))) {
+        m_result.error = fullBatch.lastError().text();
+        return false;
+    }
+
+    // rows waiting for the next statement, RowsPerStatement * FieldCount values
+    QVector<QString> pending;
+    pending.reserve(RowsPerStatement * FieldCount);
+    qint64 uncommitted = 0;
+    bool inTransaction = false;
+
+    auto flush = [&](bool all) -> bool {
+        while (pending.size() >= RowsPerStatement * FieldCount ||
+               (all && !pending.isEmpty())) {
+            const int rows = qMin<int>(RowsPerStatement, pending.size() / FieldCount);
+            QSqlQuery tail(db);
+            QSqlQuery *query = &fullBatch;
+            if (rows < RowsPerStatement) {
+                if (!tail.prepare(StudentRepository::upsertSql(rows))) {
+                    m_result.error = tail.lastError().text();
+                    return false;
+                }
+                query = &tail;
+            }
+            for (int v = 0; v < rows * FieldCount; ++v)
+                query->bindValue(v, pending.at(v));
+            if (!query->exec()) {
+                m_result.error = query->lastError().text();
+                return false;
+            }
+            pending.remove(0, rows * FieldCount);
+            uncommitted += rows;
+        }
+        return true;
+    };
+
+    auto commit = [&]() -> bool {
+        if (!inTransaction)
+            return true;
+        if (!db.commit()) {
+            m_result.error = db.lastError().text();
+            return false;
+        }
+        inTransaction = false;
+        m_result.imported += uncommitted;
+        uncommitted = 0;
+        emit progress(in.pos(), total);
+        return true;
+    };
+
+    qint64 records = 0;
+    for (; haveRecord; haveRecord = readRecord(in, fields, lineNo, raw)) {
+        recordLine = lineNo - raw.count('\n');   // first line of a multi-line record
+        if (++records % 4096 == 0)
+            emit progress(in.pos(), total);
+        if (m_cancel.load(std::memory_order_relaxed)) {
+            m_result.cancelled = true;
+            break;
+        }
+        if (fields.size() == 1 && fields[0].trimmed().isEmpty())
+            continue;   // blank line
+
+        QString values[FieldCount];
+        bool complete = true;
+        for (int f = 0; f < FieldCount; ++f) {
+            if (column[f] < 0)
+                continue;   // not in the header; stored as ''
+            if (column[f] >= fields.size()) {
+                complete = false;
+                break;
+            }
+            values[f] = QString::fromUtf8(fields[column[f]]).trimmed();
+        }
+        if (!complete) {
+            reject(recordLine, "missing columns", raw);
+            continue;
+        }
+        if (values[NameField].isEmpty()) {
+            reject(recordLine, "empty name", raw);
+            continue;
+        }
+        if (values[RollNoField].isEmpty()) {
+            reject(recordLine, "empty roll no", raw);
+            continue;
+        }
+        if (values[RollNoField].size() > MaxRollNoLength) {
+            reject(recordLine, "roll no too long", raw);
+            continue;
+        }
+
+        if (!inTransaction) {
+            if (!db.transaction()) {
+                m_result.error = db.lastError().text();
+                return false;
+            }
+            inTransaction = true;
+        }
+        // a column left out or an empty cell is a null QString, which
+        // would bind as NULL; the student list pages on course and grade
+        for (const QString &v : values)
+            pending.append(StudentRepository::blankAsEmpty(v));
+
+        if (!flush(false)) {
+            db.rollback();
+            return false;
+        }
+        if (uncommitted >= CommitRows && !commit()) {
+            db.rollback();
+            return false;
+        }
+    }
+
+    // a cancelled import keeps what was committed and drops the open batch
+    if (m_result.cancelled) {
+        if (inTransaction)
+            db.rollback();
+        return true;
+    }
+    if (inTransaction && (!flush(true) || !commit())) {
+        db.rollback();
+        return false;
+    }
+    emit progress(total, total);
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef STUDENTIMPORTER_H
+#define STUDENTIMPORTER_H
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+
+#include "studentrepository.h"
+
+// Streams a CSV file of students into the database.
+//
+// The file is read one record at a time (RFC 4180 quoting, UTF-8), so its
+// size does not matter. Valid rows are upserted on rollno with multi-row
+// INSERT ... ON CONFLICT statements, committed every CommitRows rows.
+// Rejected rows go to "<csv>.rejected.csv" with their line and reason.
+//
+// Columns are taken from a header row naming name, rollno, course and
+// grade in any order; without one they are assumed to be in that order.
+// A header must name name and rollno; course or grade left out of it are
+// imported empty.
+//
+// run() opens its own connection, so the importer can be moved to a
+// worker thread; cancel() may be called from any thread.
+class StudentImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RowsPerStatement = StudentRepository::RowsPerStatement;
+    static constexpr int CommitRows       = 50000;
+
+    struct Result {
+        qint64  imported = 0;   // inserted or updated, committed
+        qint64  rejected = 0;
+        bool    cancelled = false;
+        double  seconds = 0.0;
+        QString error;          // empty on success
+        QString rejectedReport; // path, if any row was rejected
+    };
+
+    StudentImporter(const QString &dbPath, const QString &csvPath,
+                    QObject *parent = nullptr);
+
+    void cancel() { m_cancel.store(true); }
+    Result result() const { return m_result; }
+
+public slots:
+    void run();
+
+signals:
+    void progress(qint64 bytesRead, qint64 bytesTotal);
+    void finished();
+
+private:
+    QString m_dbPath;
+    QString m_csvPath;
+    Result  m_result;
+    std::atomic<bool> m_cancel{false};
+
+    bool importInto(const QString &connectionName);
+};
+
+#endif // STUDENTIMPORTER_H
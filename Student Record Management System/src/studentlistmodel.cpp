@@ -0,0 +1,89 @@
+#include "studentlistmodel.h"
+
+StudentListModel::StudentListModel(const QSqlDatabase &db, QObject *parent)
+    : KeysetTableModel(db, ColumnCount, CachedPages, parent)
+{
+    refresh();
+}
+
+// ---------------- SQL building ----------------
+
+// each has a (column, rollno) index from schema migration 4
+QString StudentListModel::sortExpression() const
+{
+    switch (m_sortColumn) {
+    case NameColumn:   return "name";
+    case CourseColumn: return "course";
+    case GradeColumn:  return "grade";
+    default:           return "rollno";
+    }
+}
+
+KeysetTableModel::Listing StudentListModel::listing() const
+{
+    Listing l;
+    l.table = "students";
+    l.columns = "rollno, name, course, grade";
+    if (!m_filter.isEmpty())
+        l.filter << "(rollno LIKE :prefix ESCAPE '\\' OR name LIKE :infix ESCAPE '\\')";
+    if (m_sortColumn == RollNoColumn)
+        l.keys << "rollno";
+    else
+        l.keys << sortExpression() << "rollno";
+    l.order = m_sortOrder;
+    return l;
+}
+
+void StudentListModel::bindFilter(QSqlQuery &query) const
+{
+    if (m_filter.isEmpty())
+        return;
+    QString escaped = m_filter;
+    escaped.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+    query.bindValue(":prefix", escaped + "%");
+    query.bindValue(":infix", "%" + escaped + "%");
+}
+
+// ---------------- model interface ----------------
+
+QVariant StudentListModel::headerData(int section, Qt::Orientation orientation,
+                                      int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Vertical)
+        return section + 1;
+
+    switch (section) {
+    case RollNoColumn: return "Roll No";
+    case NameColumn:   return "Name";
+    case CourseColumn: return "Course";
+    case GradeColumn:  return "Grade";
+    default:           return QVariant();
+    }
+}
+
+void StudentListModel::sort(int column, Qt::SortOrder order)
+{
+    if (column < 0 || column >= ColumnCount)
+        return;
+    if (column == m_sortColumn && order == m_sortOrder)
+        return;
+    m_sortColumn = column;
+    m_sortOrder = order;
+    refresh();
+}
+
+void StudentListModel::setFilter(const QString &text)
+{
+    const QString trimmed = text.trimmed();
+    if (trimmed == m_filter)
+        return;
+    m_filter = trimmed;
+    refresh();
+}
+
+QString StudentListModel::rollNoAt(int row) const
+{
+    return data(index(row, RollNoColumn)).toString();
+}
@@ -0,0 +1,43 @@
+#ifndef STUDENTLISTMODEL_H
+#define STUDENTLISTMODEL_H
+
+#include "keysettablemodel.h"
+
+// Read-only view of the students table for very large tables.
+//
+// Pages through KeysetTableModel keyed on (sort column, rollno). Sorting
+// and the text filter are pushed into SQL.
+class StudentListModel : public KeysetTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { RollNoColumn, NameColumn, CourseColumn, GradeColumn, ColumnCount };
+
+    static constexpr int CachedPages = 32;
+
+    explicit StudentListModel(const QSqlDatabase &db, QObject *parent = nullptr);
+
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // roll numbers starting with text, or names containing it
+    void setFilter(const QString &text);
+    QString filter() const { return m_filter; }
+
+    QString rollNoAt(int row) const;
+
+protected:
+    Listing listing() const override;
+    void bindFilter(QSqlQuery &query) const override;
+
+private:
+    QString      m_filter;
+    int          m_sortColumn = RollNoColumn;
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
+
+    QString sortExpression() const;
+};
+
+#endif // STUDENTLISTMODEL_H
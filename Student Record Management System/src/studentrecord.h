@@ -0,0 +1,16 @@
+#ifndef STUDENTRECORD_H
+#define STUDENTRECORD_H
+
+#include <QString>
+
+// One row of the students table.
+struct StudentRecord
+{
+    QString name;
+    QString rollNo;
+    QString course;
+    QString grade;
+    qint64  version = 0;   // students.version as read; 0 when not known
+};
+
+#endif // STUDENTRECORD_H
@@ -0,0 +1,407 @@
+#include "studentrepository.h"
+
+#include <QSqlError>
+#include <QVariant>
+
+namespace {
+
+void fail(StudentRepository::Result &result, const QSqlError &error)
+{
+    result.ok = false;
+    result.error = error.text();
+    result.nativeCode = error.nativeErrorCode();
+}
+
+// "(?, ?), (?, ?)" style lists: count groups of width placeholders
+QString placeholders(int count, int width)
+{
+    QString group = "(?";
+    for (int i = 1; i < width; ++i)
+        group += ", ?";
+    group += ')';
+
+    QString sql;
+    sql.reserve(count * (group.size() + 2));
+    for (int i = 0; i < count; ++i) {
+        if (i) sql += ", ";
+        sql += group;
+    }
+    return sql;
+}
+
+QString inList(int count)
+{
+    QString sql = "(?";
+    for (int i = 1; i < count; ++i)
+        sql += ", ?";
+    return sql + ')';
+}
+
+QString selectInSql(int count)
+{
+    return "SELECT name, rollno, course, grade, version FROM students WHERE rollno IN " +
+           inList(count);
+}
+
+QString deleteInSql(int count)
+{
+    return "DELETE FROM students WHERE rollno IN " + inList(count);
+}
+
+QString fillLookupSql(int count)
+{
+    return "INSERT OR IGNORE INTO temp.lookup_rollnos (rollno) VALUES " + placeholders(count, 1);
+}
+
+StudentRecord readRecord(const QSqlQuery &query)
+{
+    return { query.value(0).toString(), query.value(1).toString(),
+             query.value(2).toString(), query.value(3).toString(),
+             query.value(4).toLongLong() };
+}
+
+} // namespace
+
+StudentRepository::StudentRepository(DatabaseService *db)
+    : m_db(db)
+{
+}
+
+QString StudentRepository::upsertSql(int rows)
+{
+    return "INSERT INTO students (name, rollno, course, grade) VALUES " +
+           placeholders(rows, 4) +
+           " ON CONFLICT(rollno) DO UPDATE SET"
+           " name = excluded.name, course = excluded.course, grade = excluded.grade,"
+           " version = version + 1";
+}
+
+bool StudentRepository::prepareBatch(std::unique_ptr<QSqlQuery> &slot, const QString &sql,
+                                     Result &result)
+{
+    if (slot) {
+        slot->finish();
+        return true;
+    }
+    auto query = std::make_unique<QSqlQuery>(m_db->database());
+    if (!query->prepare(sql)) {
+        fail(result, query->lastError());
+        return false;   // retried on the next call
+    }
+    slot = std::move(query);
+    return true;
+}
+
+// ---------------- single rows ----------------
+
+StudentRepository::Result StudentRepository::get(const QString &rollNo, StudentRecord &record)
+{
+    Result result;
+    QSqlQuery &query = m_db->statement(DatabaseService::SelectStudent);
+    query.bindValue(":r", rollNo);
+    if (!m_db->exec(DatabaseService::SelectStudent)) {
+        fail(result, query.lastError());
+        return result;
+    }
+    result.ok = true;
+    if (query.next()) {
+        record = { query.value(0).toString(), rollNo,
+                   query.value(1).toString(), query.value(2).toString(),
+                   query.value(3).toLongLong() };
+        result.rows = 1;
+    }
+    query.finish();
+    return result;
+}
+
+StudentRepository::Result StudentRepository::add(const StudentRecord &student)
+{
+    Result result;
+    QSqlQuery &query = m_db->statement(DatabaseService::InsertStudent);
+    query.bindValue(":name",   student.name);
+    query.bindValue(":rollno", student.rollNo);
+    query.bindValue(":course", blankAsEmpty(student.course));
+    query.bindValue(":grade",  blankAsEmpty(student.grade));
+    if (!m_db->exec(DatabaseService::InsertStudent)) {
+        fail(result, query.lastError());
+        return result;
+    }
+    result.ok = true;
+    result.rows = query.numRowsAffected();
+    return result;
+}
+
+StudentRepository::Result StudentRepository::update(const StudentRecord &student,
+                                                    StudentRecord *current)
+{
+    const DatabaseService::Statement s = student.version > 0
+        ? DatabaseService::UpdateStudentIfVersion : DatabaseService::UpdateStudent;
+
+    Result result;
+    QSqlQuery &query = m_db->statement(s);
+    query.bindValue(":name",   student.name);
+    query.bindValue(":course", blankAsEmpty(student.course));
+    query.bindValue(":grade",  blankAsEmpty(student.grade));
+    query.bindValue(":roll",   student.rollNo);
+    if (student.version > 0)
+        query.bindValue(":version", student.version);
+    if (!m_db->exec(s)) {
+        fail(result, query.lastError());
+        return result;
+    }
+    result.ok = true;
+    result.rows = query.numRowsAffected();
+    if (result.rows > 0 || student.version <= 0)
+        return result;
+
+    // nothing matched: either the row is gone or its version moved on
+    StudentRecord now;
+    const Result reread = get(student.rollNo, now);
+    if (!reread.ok)
+        return reread;
+    result.conflict = reread.rows > 0;
+    if (result.conflict && current)
+        *current = now;
+    return result;
+}
+
+StudentRepository::Result StudentRepository::remove(const QString &rollNo)
+{
+    Result result;
+    QSqlQuery &query = m_db->statement(DatabaseService::DeleteStudent);
+    query.bindValue(":roll", rollNo);
+    if (!m_db->exec(DatabaseService::DeleteStudent)) {
+        fail(result, query.lastError());
+        return result;
+    }
+    result.ok = true;
+    result.rows = query.numRowsAffected();
+    return result;
+}
+
+// ---------------- batches ----------------
+
+StudentRepository::Result StudentRepository::getMany(const QStringList &rollNos,
+                                                     QVector<StudentRecord> &records)
+{
+    records.clear();
+    if (rollNos.isEmpty()) {
+        Result result;
+        result.ok = true;
+        return result;
+    }
+    if (rollNos.size() > InListRows)
+        return lookupJoin(rollNos, records);
+
+    Result result;
+    QSqlQuery partial(m_db->database());
+    QSqlQuery *query = &partial;
+    if (rollNos.size() == InListRows) {
+        if (!prepareBatch(m_selectBatch, selectInSql(InListRows), result))
+            return result;
+        query = m_selectBatch.get();
+    } else if (!partial.prepare(selectInSql(rollNos.size()))) {
+        fail(result, partial.lastError());
+        return result;
+    }
+
+    for (int i = 0; i < rollNos.size(); ++i)
+        query->bindValue(i, rollNos.at(i));
+    if (!query->exec()) {
+        fail(result, query->lastError());
+        return result;
+    }
+    records.reserve(rollNos.size());
+    while (query->next())
+        records.append(readRecord(*query));
+    query->finish();
+
+    result.ok = true;
+    result.rows = records.size();
+    return result;
+}
+
+// the table lives in the connection's temp schema, so it is private to
+// this connection and never written to the database file
+bool StudentRepository::createLookupTable(Result &result)
+{
+    if (m_lookupTable)
+        return true;
+    QSqlQuery query(m_db->database());
+    if (!query.exec("CREATE TEMP TABLE IF NOT EXISTS lookup_rollnos "
+                    "(rollno TEXT PRIMARY KEY) WITHOUT ROWID")) {
+        fail(result, query.lastError());
+        return false;
+    }
+    m_lookupTable = true;
+    return true;
+}
+
+StudentRepository::Result StudentRepository::lookupJoin(const QStringList &rollNos,
+                                                        QVector<StudentRecord> &records)
+{
+    Result result;
+    if (!createLookupTable(result))
+        return result;
+
+    QSqlDatabase db = m_db->database();
+    if (!db.transaction()) {
+        fail(result, db.lastError());
+        return result;
+    }
+    auto failWith = [&](const QSqlError &error) {
+        fail(result, error);
+        records.clear();
+        db.rollback();
+        return result;
+    };
+
+    QSqlQuery query(db);
+    if (!query.exec("DELETE FROM temp.lookup_rollnos"))
+        return failWith(query.lastError());
+
+    for (int start = 0; start < rollNos.size(); start += RowsPerStatement) {
+        const int rows = qMin(RowsPerStatement, int(rollNos.size()) - start);
+        QSqlQuery partial(db);
+        QSqlQuery *fill = &partial;
+        if (rows == RowsPerStatement) {
+            if (!prepareBatch(m_fillLookup, fillLookupSql(RowsPerStatement), result)) {
+                db.rollback();
+                return result;
+            }
+            fill = m_fillLookup.get();
+        } else if (!partial.prepare(fillLookupSql(rows))) {
+            return failWith(partial.lastError());
+        }
+        for (int i = 0; i < rows; ++i)
+            fill->bindValue(i, rollNos.at(start + i));
+        if (!fill->exec())
+            return failWith(fill->lastError());
+    }
+
+    if (!query.exec("SELECT s.name, s.rollno, s.course, s.grade, s.version "
+                    "FROM temp.lookup_rollnos AS w JOIN students AS s ON s.rollno = w.rollno"))
+        return failWith(query.lastError());
+    records.reserve(rollNos.size());
+    while (query.next())
+        records.append(readRecord(query));
+    query.finish();
+
+    // leave the temp table empty rather than holding the roll nos
+    QSqlQuery clear(db);
+    clear.exec("DELETE FROM temp.lookup_rollnos");
+
+    if (!db.commit())
+        return failWith(db.lastError());
+    result.ok = true;
+    result.rows = records.size();
+    return result;
+}
+
+StudentRepository::Result StudentRepository::upsertMany(const QVector<StudentRecord> &students)
+{
+    Result result;
+    if (students.isEmpty()) {
+        result.ok = true;
+        return result;
+    }
+
+    QSqlDatabase db = m_db->database();
+    if (!db.transaction()) {
+        fail(result, db.lastError());
+        return result;
+    }
+
+    int changed = 0;
+    for (int start = 0; start < students.size(); start += RowsPerStatement) {
+        const int rows = qMin(RowsPerStatement, int(students.size()) - start);
+        QSqlQuery partial(db);
+        QSqlQuery *query = &partial;
+        if (rows == RowsPerStatement) {
+            if (!prepareBatch(m_upsertBatch, upsertSql(RowsPerStatement), result)) {
+                db.rollback();
+                return result;
+            }
+            query = m_upsertBatch.get();
+        } else if (!partial.prepare(upsertSql(rows))) {
+            fail(result, partial.lastError());
+            db.rollback();
+            return result;
+        }
+
+        int v = 0;
+        for (int i = start; i < start + rows; ++i) {
+            const StudentRecord &s = students.at(i);
+            query->bindValue(v++, s.name);
+            query->bindValue(v++, s.rollNo);
+            query->bindValue(v++, blankAsEmpty(s.course));
+            query->bindValue(v++, blankAsEmpty(s.grade));
+        }
+        if (!query->exec()) {
+            fail(result, query->lastError());
+            db.rollback();
+            return result;
+        }
+        changed += query->numRowsAffected();
+    }
+
+    if (!db.commit()) {
+        fail(result, db.lastError());
+        db.rollback();
+        return result;
+    }
+    result.ok = true;
+    result.rows = changed;
+    return result;
+}
+
+StudentRepository::Result StudentRepository::deleteMany(const QStringList &rollNos)
+{
+    Result result;
+    if (rollNos.isEmpty()) {
+        result.ok = true;
+        return result;
+    }
+
+    QSqlDatabase db = m_db->database();
+    if (!db.transaction()) {
+        fail(result, db.lastError());
+        return result;
+    }
+
+    int deleted = 0;
+    for (int start = 0; start < rollNos.size(); start += InListRows) {
+        const int rows = qMin(InListRows, int(rollNos.size()) - start);
+        QSqlQuery partial(db);
+        QSqlQuery *query = &partial;
+        if (rows == InListRows) {
+            if (!prepareBatch(m_deleteBatch, deleteInSql(InListRows), result)) {
+                db.rollback();
+                return result;
+            }
+            query = m_deleteBatch.get();
+        } else if (!partial.prepare(deleteInSql(rows))) {
+            fail(result, partial.lastError());
+            db.rollback();
+            return result;
+        }
+
+        for (int i = 0; i < rows; ++i)
+            query->bindValue(i, rollNos.at(start + i));
+        if (!query->exec()) {
+            fail(result, query->lastError());
+            db.rollback();
+            return result;
+        }
+        deleted += query->numRowsAffected();
+    }
+
+    if (!db.commit()) {
+        fail(result, db.lastError());
+        db.rollback();
+        return result;
+    }
+    result.ok = true;
+    result.rows = deleted;
+    return result;
+}
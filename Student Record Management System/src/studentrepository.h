@@ -0,0 +1,87 @@
+#ifndef STUDENTREPOSITORY_H
+#define STUDENTREPOSITORY_H
+
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+
+#include "databaseservice.h"
+#include "studentrecord.h"
+
+// Every read and write of the students table. Single-row calls go through
+// the service's prepared-statement cache; batch calls bind up to
+// RowsPerStatement rows into one multi-row statement, keep the full-size
+// statements prepared between calls and run each batch in one
+// transaction, so a batch either applies completely or not at all.
+//
+// Every write bumps the row's version. An update carrying the version it
+// was read at only applies if nobody has written the row since.
+class StudentRepository
+{
+public:
+    static constexpr int RowsPerStatement = 200;   // 800 bound values
+    static constexpr int InListRows       = 500;   // roll nos per IN (...)
+
+    struct Result {
+        bool    ok = false;
+        int     rows = 0;        // rows found, or rows changed
+        bool    conflict = false;   // update(): written by someone else since
+        QString error;           // driver text when !ok
+        QString nativeCode;      // SQLite result code, e.g. "2067"
+    };
+
+    // db is owned by the caller and outlives the repository
+    explicit StudentRepository(DatabaseService *db);
+
+    // rows is 1 and record is filled if the roll no exists
+    Result get(const QString &rollNo, StudentRecord &record);
+    Result add(const StudentRecord &student);
+
+    Result remove(const QString &rollNo);
+
+    // With student.version set, a row written by someone else since is
+    // left alone: rows is 0, conflict is set and current (if given)
+    // receives the row as it is now. With version 0 the update is
+    // unconditional.
+    Result update(const StudentRecord &student, StudentRecord *current = nullptr);
+
+    // Every listed student that exists, in no particular order; unknown
+    // roll nos are left out. Up to InListRows are matched with one IN
+    // list, more through a temporary table joined against students.
+    Result getMany(const QStringList &rollNos, QVector<StudentRecord> &records);
+
+    // inserts new roll nos and overwrites the rest
+    Result upsertMany(const QVector<StudentRecord> &students);
+
+    Result deleteMany(const QStringList &rollNos);
+
+    // INSERT ... ON CONFLICT(rollno) DO UPDATE for rows students, four
+    // positional values per row; an overwritten row gets a new version
+    static QString upsertSql(int rows);
+
+    // what to bind for course and grade: a blank one is stored as '',
+    // never NULL, so the student list can page on it (schema step 4)
+    static QString blankAsEmpty(const QString &text)
+    {
+        return text.isNull() ? QString("") : text;
+    }
+
+private:
+    DatabaseService *m_db;
+
+    // full-size batch statements; partial batches are prepared per call
+    std::unique_ptr<QSqlQuery> m_upsertBatch;
+    std::unique_ptr<QSqlQuery> m_selectBatch;
+    std::unique_ptr<QSqlQuery> m_deleteBatch;
+    std::unique_ptr<QSqlQuery> m_fillLookup;
+    bool m_lookupTable = false;
+
+    bool prepareBatch(std::unique_ptr<QSqlQuery> &slot, const QString &sql, Result &result);
+    bool createLookupTable(Result &result);
+    Result lookupJoin(const QStringList &rollNos, QVector<StudentRecord> &records);
+};
+
+#endif // STUDENTREPOSITORY_H
@@ -0,0 +1,151 @@
+#include "studentsearch.h"
+#include "databaseservice.h"
+
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+namespace {
+
+// "ann sm" -> "ann"* "sm"*; quotes keep FTS5 operators in the input literal
+QString ftsQuery(const QString &text)
+{
+    static const QRegularExpression separators("[\\s\\p{P}\\p{S}]+");
+    QStringList terms;
+    for (QString word : text.split(separators, Qt::SkipEmptyParts)) {
+        word.replace('"', "\"\"");
+        terms << '"' + word + "\"*";
+    }
+    return terms.join(' ');
+}
+
+QString likePattern(const QString &text)
+{
+    QString escaped = text;
+    escaped.replace('\\', "\\\\").replace('%', "\\%").replace('_', "\\_");
+    return '%' + escaped + '%';
+}
+
+// smallest string greater than every string starting with prefix
+QString prefixUpperBound(const QString &prefix)
+{
+    QString upper = prefix;
+    upper[upper.size() - 1] = QChar(upper.at(upper.size() - 1).unicode() + 1);
+    return upper;
+}
+
+} // namespace
+
+StudentSearch::StudentSearch(const QString &dbPath, QObject *parent)
+    : QObject(parent)
+    , m_dbPath(dbPath)
+{
+    qRegisterMetaType<StudentSearch::Hits>();
+}
+
+// destroyed on the worker thread, which also owns the connection
+StudentSearch::~StudentSearch() = default;
+
+bool StudentSearch::ensureOpen(QString &error)
+{
+    if (m_service)
+        return true;
+
+    auto service = std::make_unique<DatabaseService>(
+        QString("students-search-%1").arg(reinterpret_cast<quintptr>(this), 0, 16));
+    if (!service->open(m_dbPath)) {
+        error = service->lastError();
+        return false;
+    }
+    QSqlQuery probe(service->database());
+    m_hasFts = probe.exec("SELECT 1 FROM sqlite_master "
+                          "WHERE type = 'table' AND name = 'students_fts'") && probe.next();
+    m_service = std::move(service);
+    return true;
+}
+
+void StudentSearch::search(quint64 ticket, const QString &text, int limit)
+{
+    if (ticket < m_latest.load())
+        return;   // the user kept typing
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString error;
+    if (!ensureOpen(error)) {
+        emit failed(ticket, error);
+        return;
+    }
+
+    const QString trimmed = text.trimmed();
+    Hits hits;
+    if (trimmed.isEmpty() || limit <= 0) {
+        emit resultsReady(ticket, hits, 0.0);
+        return;
+    }
+
+    QSqlDatabase db = m_service->database();
+    auto collect = [&](QSqlQuery &query) {
+        while (hits.size() < limit && query.next()) {
+            Hit hit{ query.value(0).toString(), query.value(1).toString(),
+                     query.value(2).toString(), query.value(3).toString() };
+            bool seen = false;
+            for (const Hit &h : hits) {
+                if (h.rollNo == hit.rollNo) {
+                    seen = true;
+                    break;
+                }
+            }
+            if (!seen)
+                hits.append(hit);
+        }
+    };
+
+    // roll number prefix: a range scan on the unique index
+    QSqlQuery byRoll(db);
+    byRoll.setForwardOnly(true);
+    byRoll.prepare("SELECT rollno, name, course, grade FROM students"
+                   " WHERE rollno >= :lo AND rollno < :hi ORDER BY rollno LIMIT :n");
+    byRoll.bindValue(":lo", trimmed);
+    byRoll.bindValue(":hi", prefixUpperBound(trimmed));
+    byRoll.bindValue(":n", limit);
+    if (!byRoll.exec()) {
+        emit failed(ticket, byRoll.lastError().text());
+        return;
+    }
+    collect(byRoll);
+
+    const QString match = ftsQuery(trimmed);
+    if (hits.size() < limit && !match.isEmpty()) {
+        QSqlQuery byText(db);
+        byText.setForwardOnly(true);
+        if (m_hasFts) {
+            // scoring every match of a one-letter prefix costs ~100 ms on
+            // 500k rows, so only the first RankCandidates matches are ranked
+            byText.prepare("SELECT s.rollno, s.name, s.course, s.grade FROM"
+                           " (SELECT rowid, bm25(students_fts, 10.0, 2.0, 5.0) AS score"
+                           "  FROM students_fts WHERE students_fts MATCH :q LIMIT :candidates) f"
+                           " JOIN students s ON s.id = f.rowid"
+                           " ORDER BY f.score LIMIT :n");
+            byText.bindValue(":q", match);
+            byText.bindValue(":candidates", RankCandidates);
+        } else {
+            byText.prepare("SELECT rollno, name, course, grade FROM students"
+                           " WHERE name LIKE :p1 ESCAPE '\\' OR course LIKE :p2 ESCAPE '\\'"
+                           " ORDER BY name, rollno LIMIT :n");
+            byText.bindValue(":p1", likePattern(trimmed));
+            byText.bindValue(":p2", likePattern(trimmed));
+        }
+        byText.bindValue(":n", limit);
+        if (!byText.exec()) {
+            emit failed(ticket, byText.lastError().text());
+            return;
+        }
+        collect(byText);
+    }
+
+    emit resultsReady(ticket, hits, timer.nsecsElapsed() / 1e6);
+}
@@ -0,0 +1,64 @@
+#ifndef STUDENTSEARCH_H
+#define STUDENTSEARCH_H
+
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+class DatabaseService;
+
+// Search-as-you-type over students, meant to live on a worker thread.
+//
+// Each word of the query matches the start of a word in the name, course
+// or roll number (FTS5 prefix query, ranked by bm25 with name weighted
+// highest); roll numbers that start with the whole query come first.
+// Very broad queries rank only their first RankCandidates matches.
+// Without FTS5 in the SQLite build it falls back to LIKE matching.
+//
+// search() calls are queued; a request already superseded by a newer
+// ticket is skipped, so a fast typist only pays for the last query.
+class StudentSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultLimit   = 50;
+    static constexpr int RankCandidates = 2000;
+
+    struct Hit {
+        QString rollNo;
+        QString name;
+        QString course;
+        QString grade;
+    };
+    using Hits = QVector<Hit>;
+
+    explicit StudentSearch(const QString &dbPath, QObject *parent = nullptr);
+    ~StudentSearch() override;
+
+    // call from any thread before queueing search(ticket, ...)
+    void supersede(quint64 ticket) { m_latest.store(ticket); }
+
+public slots:
+    void search(quint64 ticket, const QString &text, int limit = DefaultLimit);
+
+signals:
+    void resultsReady(quint64 ticket, const StudentSearch::Hits &hits, double ms);
+    void failed(quint64 ticket, const QString &error);
+
+private:
+    QString m_dbPath;
+    std::unique_ptr<DatabaseService> m_service;   // opened on first search
+    bool    m_hasFts = false;
+    std::atomic<quint64> m_latest{0};
+
+    bool ensureOpen(QString &error);
+};
+
+Q_DECLARE_METATYPE(StudentSearch::Hits)
+
+#endif // STUDENTSEARCH_H
@@ -0,0 +1,370 @@
+#include "syncclient.h"
+#include "busyretry.h"
+#include "databaseservice.h"
+#include "studentrepository.h"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QUrlQuery>
+#include <QVariant>
+
+// ---------------- SyncChange ----------------
+
+QJsonObject SyncChange::toJson() const
+{
+    QJsonObject o;
+    if (seq > 0)
+        o["seq"] = seq;
+    o["rollno"] = rollNo;
+    o["deleted"] = deleted;
+    if (!deleted) {
+        o["name"] = name;
+        o["course"] = course;
+        o["grade"] = grade;
+    }
+    o["changed_at"] = changedAt;
+    o["site"] = site;
+    return o;
+}
+
+SyncChange SyncChange::fromJson(const QJsonObject &o)
+{
+    SyncChange c;
+    c.seq       = o["seq"].toInteger();
+    c.rollNo    = o["rollno"].toString();
+    c.deleted   = o["deleted"].toBool();
+    c.name      = o["name"].toString();
+    c.course    = o["course"].toString();
+    c.grade     = o["grade"].toString();
+    c.changedAt = o["changed_at"].toInteger();
+    c.site      = o["site"].toString();
+    return c;
+}
+
+// ---------------- SyncClient ----------------
+
+SyncClient::SyncClient(const QString &dbPath, const QUrl &server, QObject *parent)
+    : QObject(parent)
+    , m_dbPath(dbPath)
+    , m_server(server)
+    , m_network(new QNetworkAccessManager(this))
+{
+}
+
+SyncClient::~SyncClient() = default;
+
+QUrl SyncClient::endpoint(const QString &name) const
+{
+    QUrl url = m_server;
+    QString path = url.path();
+    if (!path.endsWith('/'))
+        path += '/';
+    url.setPath(path + name);
+    return url;
+}
+
+bool SyncClient::openDatabase()
+{
+    if (m_db)
+        return true;
+    auto db = std::make_unique<DatabaseService>(
+        QString("students-sync-%1").arg(reinterpret_cast<quintptr>(this), 0, 16));
+    if (!db->open(m_dbPath) || !db->duplicateRollNos().isEmpty()) {
+        // pulled rows are applied with ON CONFLICT(rollno), which needs the
+        // unique index that duplicates hold back
+        m_result.error = db->duplicateRollNos().isEmpty()
+            ? db->lastError()
+            : QString("Fix the duplicate roll numbers before syncing.");
+        return false;
+    }
+
+    QSqlQuery query(db->database());
+    if (!query.exec("SELECT value FROM sync_state WHERE key = 'site'") || !query.next()) {
+        m_result.error = "No sync state: " + query.lastError().text();
+        return false;
+    }
+    m_site = query.value(0).toString();
+    query.finish();
+    m_db = std::move(db);
+    return true;
+}
+
+// -1 on failure
+qint64 SyncClient::stateValue(const QString &key)
+{
+    QSqlQuery query(m_db->database());
+    query.prepare("SELECT value FROM sync_state WHERE key = :key");
+    query.bindValue(":key", key);
+    if (!query.exec() || !query.next())
+        return -1;
+    return query.value(0).toLongLong();
+}
+
+bool SyncClient::setStateValue(const QString &key, qint64 value)
+{
+    QSqlQuery query(m_db->database());
+    query.prepare("UPDATE sync_state SET value = :value WHERE key = :key");
+    query.bindValue(":value", QString::number(value));
+    query.bindValue(":key", key);
+    return query.exec() && query.numRowsAffected() == 1;
+}
+
+void SyncClient::sync()
+{
+    m_result = Result();
+    m_startedMs = QDateTime::currentMSecsSinceEpoch();
+    if (!openDatabase()) {
+        finish(m_result.error);
+        return;
+    }
+    pushNext();
+}
+
+void SyncClient::finish(const QString &error)
+{
+    m_result.ok = error.isEmpty();
+    m_result.error = error;
+    m_result.seconds = (QDateTime::currentMSecsSinceEpoch() - m_startedMs) / 1000.0;
+    emit finished();
+}
+
+// ---------------- push ----------------
+
+void SyncClient::pushNext()
+{
+    const qint64 from = stateValue("pushed_seq");
+    if (from < 0) {
+        finish("Cannot read pushed_seq.");
+        return;
+    }
+
+    // rows applied from the server are skipped, not pushed back
+    QSqlQuery query(m_db->database());
+    query.setForwardOnly(true);
+    query.prepare("SELECT c.seq, c.rollno, c.deleted, c.changed_at, s.name, s.course, s.grade "
+                  "FROM change_log AS c LEFT JOIN students AS s ON s.rollno = c.rollno "
+                  "WHERE c.seq > :from AND c.origin = 'local' "
+                  "ORDER BY c.seq LIMIT :limit");
+    query.bindValue(":from", from);
+    query.bindValue(":limit", BatchSize);
+    if (!query.exec()) {
+        finish("Cannot read the change log: " + query.lastError().text());
+        return;
+    }
+
+    QJsonArray changes;
+    while (query.next()) {
+        SyncChange c;
+        c.rollNo    = query.value(1).toString();
+        c.deleted   = query.value(2).toBool() || query.value(4).isNull();
+        c.changedAt = query.value(3).toLongLong();
+        c.site      = m_site;
+        if (!c.deleted) {
+            c.name   = query.value(4).toString();
+            c.course = query.value(5).toString();
+            c.grade  = query.value(6).toString();
+        }
+        changes.append(c.toJson());
+        m_batchEnd = query.value(0).toLongLong();
+    }
+    query.finish();
+
+    if (changes.isEmpty()) {
+        pullNext();
+        return;
+    }
+
+    QJsonObject body;
+    body["site"] = m_site;
+    body["changes"] = changes;
+
+    QNetworkRequest request(endpoint("push"));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    request.setTransferTimeout(TimeoutMs);
+    QNetworkReply *reply =
+        m_network->post(request, QJsonDocument(body).toJson(QJsonDocument::Compact));
+    const int count = changes.size();
+    connect(reply, &QNetworkReply::finished, this, [this, reply, count]() { pushed(reply, count); });
+}
+
+void SyncClient::pushed(QNetworkReply *reply, int count)
+{
+    reply->deleteLater();
+    if (reply->error() != QNetworkReply::NoError) {
+        finish("Push failed: " + reply->errorString());
+        return;
+    }
+    const QJsonObject answer = QJsonDocument::fromJson(reply->readAll()).object();
+    const QJsonArray rejected = answer["rejected"].toArray();
+    const int accepted = answer["accepted"].toInt(-1);
+    if (accepted < 0 || accepted + rejected.size() != count) {
+        finish("Push failed: unexpected answer from the server.");
+        return;
+    }
+
+    QVector<SyncChange> winners;
+    winners.reserve(rejected.size());
+    for (const QJsonValue &v : rejected)
+        winners.append(SyncChange::fromJson(v.toObject()));
+
+    // the server has the batch; changes made meanwhile got a higher seq and
+    // still go up next time. Ours that lost give way to the winners.
+    BusyRetry retry;
+    const Applied applied = retry.run(
+        [&]() { return applyChanges(winners, m_batchEnd, "pushed_seq", m_batchEnd); });
+    if (!applied.ok) {
+        finish("Cannot record the push: " + applied.error);
+        return;
+    }
+    m_result.pushed += accepted;
+    m_result.lost += winners.size();
+    m_result.keptLocal += applied.kept;
+    if (count == BatchSize)
+        pushNext();
+    else
+        pullNext();
+}
+
+// ---------------- pull ----------------
+
+void SyncClient::pullNext()
+{
+    const qint64 since = stateValue("pulled_seq");
+    if (since < 0) {
+        finish("Cannot read pulled_seq.");
+        return;
+    }
+
+    QUrl url = endpoint("pull");
+    QUrlQuery query;
+    query.addQueryItem("since", QString::number(since));
+    query.addQueryItem("site", m_site);
+    query.addQueryItem("limit", QString::number(BatchSize));
+    url.setQuery(query);
+
+    QNetworkRequest request(url);
+    request.setTransferTimeout(TimeoutMs);
+    QNetworkReply *reply = m_network->get(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { pulled(reply); });
+}
+
+void SyncClient::pulled(QNetworkReply *reply)
+{
+    reply->deleteLater();
+    if (reply->error() != QNetworkReply::NoError) {
+        finish("Pull failed: " + reply->errorString());
+        return;
+    }
+    const QJsonObject answer = QJsonDocument::fromJson(reply->readAll()).object();
+    if (!answer.contains("last")) {
+        finish("Pull failed: unexpected answer from the server.");
+        return;
+    }
+
+    QVector<SyncChange> changes;
+    const QJsonArray list = answer["changes"].toArray();
+    changes.reserve(list.size());
+    for (const QJsonValue &v : list)
+        changes.append(SyncChange::fromJson(v.toObject()));
+
+    const qint64 pushedSeq = stateValue("pushed_seq");
+    if (pushedSeq < 0) {
+        finish("Cannot read pushed_seq.");
+        return;
+    }
+    BusyRetry retry;
+    const Applied applied = retry.run([&]() {
+        return applyChanges(changes, pushedSeq, "pulled_seq", answer["last"].toInteger());
+    });
+    if (!applied.ok) {
+        finish("Cannot apply pulled changes: " + applied.error);
+        return;
+    }
+    m_result.pulled += applied.applied;
+    m_result.keptLocal += applied.kept;
+
+    if (answer["more"].toBool() && !changes.isEmpty())
+        pullNext();
+    else
+        finish();
+}
+
+// changes that won at the server, in one transaction together with the new
+// sync position; a local change logged after unpushedAfter has not reached
+// the server and stays if it supersedes the incoming one
+SyncClient::Applied SyncClient::applyChanges(const QVector<SyncChange> &changes,
+                                             qint64 unpushedAfter,
+                                             const QString &stateKey, qint64 position)
+{
+    Applied out;
+    QSqlDatabase db = m_db->database();
+    auto fail = [&](const QSqlError &error) {
+        out.ok = false;
+        out.error = error.text();
+        out.nativeCode = error.nativeErrorCode();
+        db.rollback();
+        return out;
+    };
+    if (!db.transaction())
+        return fail(db.lastError());
+
+    QSqlQuery local(db);
+    local.prepare("SELECT changed_at FROM change_log "
+                  "WHERE rollno = :rollno AND origin = 'local' AND seq > :pushed");
+    QSqlQuery upsert(db);
+    upsert.prepare(StudentRepository::upsertSql(1));
+    QSqlQuery remove(db);
+    remove.prepare("DELETE FROM students WHERE rollno = :rollno");
+    // the triggers logged the write as ours; it is the server's
+    QSqlQuery mark(db);
+    mark.prepare("UPDATE change_log SET origin = 'remote', changed_at = :at "
+                 "WHERE rollno = :rollno");
+
+    for (const SyncChange &c : changes) {
+        local.bindValue(":rollno", c.rollNo);
+        local.bindValue(":pushed", unpushedAfter);
+        if (!local.exec())
+            return fail(local.lastError());
+        if (local.next()) {
+            SyncChange mine;
+            mine.changedAt = local.value(0).toLongLong();
+            mine.site = m_site;
+            local.finish();
+            if (mine.supersedes(c)) {
+                ++out.kept;
+                continue;
+            }
+        }
+
+        if (c.deleted) {
+            remove.bindValue(":rollno", c.rollNo);
+            if (!remove.exec())
+                return fail(remove.lastError());
+        } else {
+            upsert.bindValue(0, c.name);
+            upsert.bindValue(1, c.rollNo);
+            upsert.bindValue(2, StudentRepository::blankAsEmpty(c.course));
+            upsert.bindValue(3, StudentRepository::blankAsEmpty(c.grade));
+            if (!upsert.exec())
+                return fail(upsert.lastError());
+        }
+        mark.bindValue(":at", c.changedAt);
+        mark.bindValue(":rollno", c.rollNo);
+        if (!mark.exec())
+            return fail(mark.lastError());
+        ++out.applied;
+    }
+
+    if (!setStateValue(stateKey, position))
+        return fail(QSqlError("Cannot update " + stateKey + "."));
+    if (!db.commit())
+        return fail(db.lastError());
+    out.ok = true;
+    return out;
+}
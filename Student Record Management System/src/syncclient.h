@@ -0,0 +1,137 @@
+#ifndef SYNCCLIENT_H
+#define SYNCCLIENT_H
+
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QUrl>
+#include <QVector>
+
+#include <memory>
+
+class DatabaseService;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+// One student's latest change, as exchanged with the sync server.
+struct SyncChange
+{
+    qint64  seq = 0;         // server sequence; 0 on the way up
+    QString rollNo;
+    bool    deleted = false;
+    QString name;            // empty when deleted
+    QString course;
+    QString grade;
+    qint64  changedAt = 0;   // ms since the epoch, on the site that made it
+    QString site;            // sync_state 'site' of the database that made it
+
+    // Last writer wins; equal times go to the larger site id. Every site
+    // and the server apply the same rule, so they agree on the winner
+    // whatever order changes arrive in.
+    bool supersedes(const SyncChange &other) const {
+        return changedAt != other.changedAt ? changedAt > other.changedAt
+                                            : site > other.site;
+    }
+
+    QJsonObject toJson() const;
+    static SyncChange fromJson(const QJsonObject &o);
+};
+
+// Exchanges changes to the students table with a central server, so that
+// campuses running their own copy of the database converge.
+//
+// Triggers record every write in change_log, one row per roll number
+// holding its newest change under an ever-growing seq. A sync pushes the
+// local rows past the last acknowledged seq, then pulls what other sites
+// pushed since the last server seq it saw, BatchSize changes per request.
+// Both positions live in sync_state and only move once the server has
+// answered (push) or the batch is committed (pull), so an interrupted
+// sync resumes where it stopped. Work is proportional to the changes,
+// never to the size of the table.
+//
+// A pulled change loses to a local one not yet pushed if the local one
+// supersedes it; that one then goes up on the next push. A pushed change
+// that loses at the server comes back in the push answer as the winning
+// change and is applied here with the new pushed position, since the
+// server may hold the winner under a seq this site has already pulled.
+//
+// The site id is made by the schema migration. A database file copied
+// from another campus carries that campus's id and sync positions; reset
+// all three rows of sync_state before its first sync.
+//
+// Protocol, JSON over HTTP:
+//   POST <server>/push  {"site": S, "changes": [change, ...]}
+//                       -> {"accepted": n, "rejected": [change, ...]}
+//   GET  <server>/pull?since=N&site=S&limit=L
+//                       -> {"changes": [change, ...], "last": M, "more": bool}
+// where a change is SyncChange::toJson(), "rejected" holds the server's
+// winning change for each pushed one that lost, and the pull leaves out
+// the requesting site's own changes.
+//
+// tools/MockSyncServer.cpp is a local server speaking this protocol.
+class SyncClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int BatchSize = 500;
+    static constexpr int TimeoutMs = 30000;   // per request
+
+    struct Result {
+        bool    ok = false;
+        qint64  pushed = 0;       // accepted by the server
+        qint64  lost = 0;         // pushed, but the server had a newer one
+        qint64  pulled = 0;       // applied here
+        qint64  keptLocal = 0;    // pulled, but a newer local change won
+        double  seconds = 0.0;
+        QString error;
+    };
+
+    SyncClient(const QString &dbPath, const QUrl &server, QObject *parent = nullptr);
+    ~SyncClient() override;
+
+    QString siteId() const { return m_site; }
+    Result result() const { return m_result; }
+
+public slots:
+    // push, then pull; emits finished() once done either way
+    void sync();
+
+signals:
+    void finished();
+
+private:
+    QString m_dbPath;
+    QUrl    m_server;
+    QString m_site;
+    std::unique_ptr<DatabaseService> m_db;
+    QNetworkAccessManager *m_network;
+    qint64  m_startedMs = 0;
+    Result  m_result;
+
+    // seq of the last change in the batch in flight
+    qint64 m_batchEnd = 0;
+
+    bool openDatabase();
+    qint64 stateValue(const QString &key);
+    bool setStateValue(const QString &key, qint64 value);
+
+    void pushNext();
+    void pushed(QNetworkReply *reply, int count);
+    void pullNext();
+    void pulled(QNetworkReply *reply);
+
+    struct Applied {
+        bool    ok = false;
+        qint64  applied = 0;
+        qint64  kept = 0;
+        QString error;
+        QString nativeCode;
+    };
+    Applied applyChanges(const QVector<SyncChange> &changes, qint64 unpushedAfter,
+                         const QString &stateKey, qint64 position);
+    QUrl endpoint(const QString &name) const;
+    void finish(const QString &error = QString());
+};
+
+#endif // SYNCCLIENT_H
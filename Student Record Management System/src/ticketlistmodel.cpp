@@ -0,0 +1,84 @@
+#include "ticketlistmodel.h"
+
+#include <QDateTime>
+
+TicketListModel::TicketListModel(const QSqlDatabase &db, QObject *parent)
+    : KeysetTableModel(db, ColumnCount, CachedPages, parent)
+{
+    refresh();
+}
+
+// ---------------- SQL building ----------------
+
+// status alone uses idx_tickets_status, user (+ status) idx_tickets_user_status
+// and dates idx_tickets_created; the first two already come in id order
+KeysetTableModel::Listing TicketListModel::listing() const
+{
+    Listing l;
+    l.table = "tickets";
+    l.columns = "id, user, subject, message, status, created_at";
+    if (!m_filter.status.isEmpty())
+        l.filter << "status = :status";
+    if (!m_filter.user.isEmpty())
+        l.filter << "user = :user";
+    if (m_filter.from.isValid())
+        l.filter << "created_at >= :from";
+    if (m_filter.to.isValid())
+        l.filter << "created_at < :to";
+    l.keys << "id";
+    l.order = Qt::DescendingOrder;
+    return l;
+}
+
+void TicketListModel::bindFilter(QSqlQuery &query) const
+{
+    if (!m_filter.status.isEmpty())
+        query.bindValue(":status", m_filter.status);
+    if (!m_filter.user.isEmpty())
+        query.bindValue(":user", m_filter.user);
+    if (m_filter.from.isValid())
+        query.bindValue(":from", QDateTime(m_filter.from, QTime(0, 0)).toSecsSinceEpoch());
+    if (m_filter.to.isValid())
+        query.bindValue(":to", QDateTime(m_filter.to.addDays(1), QTime(0, 0)).toSecsSinceEpoch());
+}
+
+QVariant TicketListModel::displayValue(int column, const QVariant &value) const
+{
+    if (column != CreatedColumn)
+        return value;
+    return QDateTime::fromSecsSinceEpoch(value.toLongLong()).toString("yyyy-MM-dd hh:mm");
+}
+
+// ---------------- model interface ----------------
+
+QVariant TicketListModel::headerData(int section, Qt::Orientation orientation,
+                                     int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Vertical)
+        return section + 1;
+
+    switch (section) {
+    case IdColumn:      return "Ticket";
+    case UserColumn:    return "User";
+    case SubjectColumn: return "Subject";
+    case MessageColumn: return "Issue";
+    case StatusColumn:  return "Status";
+    case CreatedColumn: return "Raised";
+    default:            return QVariant();
+    }
+}
+
+void TicketListModel::setFilter(const Filter &filter)
+{
+    if (filter == m_filter)
+        return;
+    m_filter = filter;
+    refresh();
+}
+
+qint64 TicketListModel::idAt(int row) const
+{
+    return data(index(row, IdColumn)).toLongLong();
+}
@@ -0,0 +1,52 @@
+#ifndef TICKETLISTMODEL_H
+#define TICKETLISTMODEL_H
+
+#include "keysettablemodel.h"
+
+#include <QDate>
+
+// Read-only, newest-first view of the tickets table for the admin queue.
+//
+// Pages through KeysetTableModel keyed on the id. The status, user and
+// date filters are pushed into SQL.
+class TicketListModel : public KeysetTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { IdColumn, UserColumn, SubjectColumn, MessageColumn,
+                  StatusColumn, CreatedColumn, ColumnCount };
+
+    static constexpr int CachedPages = 16;
+
+    struct Filter {
+        QString status;   // "open", "resolved" or empty for any
+        QString user;     // exact login name, or empty for any
+        QDate   from;     // inclusive; null for no lower bound
+        QDate   to;       // inclusive; null for no upper bound
+
+        bool operator==(const Filter &o) const {
+            return status == o.status && user == o.user && from == o.from && to == o.to;
+        }
+    };
+
+    explicit TicketListModel(const QSqlDatabase &db, QObject *parent = nullptr);
+
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    void setFilter(const Filter &filter);
+    Filter filter() const { return m_filter; }
+
+    qint64 idAt(int row) const;
+
+protected:
+    Listing listing() const override;
+    void bindFilter(QSqlQuery &query) const override;
+    QVariant displayValue(int column, const QVariant &value) const override;
+
+private:
+    Filter m_filter;
+};
+
+#endif // TICKETLISTMODEL_H
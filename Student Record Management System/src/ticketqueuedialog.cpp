@@ -0,0 +1,190 @@
+#include "ticketqueuedialog.h"
+#include "ticketlistmodel.h"
+
+#include <QComboBox>
+#include <QDateEdit>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QItemSelectionModel>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSqlQuery>
+#include <QTableView>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace {
+
+// the minimum date stands for "no bound" and shows as "Any"
+QDateEdit *makeDateEdit(QWidget *parent)
+{
+    QDateEdit *edit = new QDateEdit(parent);
+    edit->setCalendarPopup(true);
+    edit->setDisplayFormat("yyyy-MM-dd");
+    edit->setMinimumDate(QDate(2000, 1, 1));
+    edit->setSpecialValueText("Any");
+    edit->setDate(edit->minimumDate());
+    return edit;
+}
+
+} // namespace
+
+TicketQueueDialog::TicketQueueDialog(DatabaseService *db, QWidget *parent)
+    : QDialog(parent)
+    , m_db(db)
+    , m_tickets(db)
+{
+    setWindowTitle("Ticket Queue");
+    resize(900, 600);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(20, 20, 20, 20);
+    layout->setSpacing(12);
+
+    // ---------------- filters ----------------
+    QHBoxLayout *filterLayout = new QHBoxLayout;
+    filterLayout->setSpacing(10);
+
+    statusBox = new QComboBox(this);
+    statusBox->addItem("Open", "open");
+    statusBox->addItem("Resolved", "resolved");
+    statusBox->addItem("All", QString());
+
+    userEdit = new QLineEdit(this);
+    userEdit->setPlaceholderText("User");
+    userEdit->setClearButtonEnabled(true);
+
+    fromEdit = makeDateEdit(this);
+    toEdit   = makeDateEdit(this);
+
+    filterLayout->addWidget(new QLabel("Status:", this));
+    filterLayout->addWidget(statusBox);
+    filterLayout->addWidget(new QLabel("User:", this));
+    filterLayout->addWidget(userEdit, 1);
+    filterLayout->addWidget(new QLabel("From:", this));
+    filterLayout->addWidget(fromEdit);
+    filterLayout->addWidget(new QLabel("To:", this));
+    filterLayout->addWidget(toEdit);
+
+    // ---------------- table ----------------
+    m_model = new TicketListModel(m_db->database(), this);
+
+    ticketView = new QTableView(this);
+    ticketView->setModel(m_model);
+    ticketView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ticketView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    ticketView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    ticketView->verticalHeader()->hide();
+    ticketView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ticketView->horizontalHeader()->setStretchLastSection(true);
+    ticketView->setColumnWidth(TicketListModel::IdColumn, 70);
+    ticketView->setColumnWidth(TicketListModel::UserColumn, 110);
+    ticketView->setColumnWidth(TicketListModel::SubjectColumn, 200);
+    ticketView->setColumnWidth(TicketListModel::MessageColumn, 250);
+    ticketView->setColumnWidth(TicketListModel::StatusColumn, 80);
+
+    // ---------------- buttons ----------------
+    QHBoxLayout *btnLayout = new QHBoxLayout;
+    openCountLabel = new QLabel(this);
+    resolveButton = new QPushButton("Resolve Selected", this);
+    resolveButton->setEnabled(false);
+    QPushButton *closeBtn = new QPushButton("Close", this);
+    btnLayout->addWidget(openCountLabel);
+    btnLayout->addStretch();
+    btnLayout->addWidget(resolveButton);
+    btnLayout->addWidget(closeBtn);
+
+    layout->addLayout(filterLayout);
+    layout->addWidget(ticketView, 1);
+    layout->addLayout(btnLayout);
+
+    filterTimer = new QTimer(this);
+    filterTimer->setSingleShot(true);
+    filterTimer->setInterval(250);
+
+    // PRAGMA data_version only moves when another connection commits, so a
+    // poll that finds it unchanged costs next to nothing
+    pollTimer = new QTimer(this);
+    pollTimer->setInterval(2000);
+
+    connect(statusBox, &QComboBox::currentIndexChanged, this, &TicketQueueDialog::applyFilter);
+    connect(fromEdit,  &QDateEdit::dateChanged,         this, &TicketQueueDialog::applyFilter);
+    connect(toEdit,    &QDateEdit::dateChanged,         this, &TicketQueueDialog::applyFilter);
+    connect(userEdit,  &QLineEdit::textChanged, filterTimer, qOverload<>(&QTimer::start));
+    connect(filterTimer, &QTimer::timeout, this, &TicketQueueDialog::applyFilter);
+    connect(pollTimer, &QTimer::timeout, this, &TicketQueueDialog::pollOpenCount);
+    connect(resolveButton, &QPushButton::clicked, this, &TicketQueueDialog::resolveSelected);
+    connect(closeBtn, &QPushButton::clicked, this, &QDialog::accept);
+
+    connect(ticketView->selectionModel(), &QItemSelectionModel::selectionChanged, this,
+            [this]() { resolveButton->setEnabled(ticketView->selectionModel()->hasSelection()); });
+    connect(m_model, &QAbstractItemModel::modelReset, this,
+            [this]() { resolveButton->setEnabled(false); });
+
+    applyFilter();
+    updateOpenCount();
+    pollTimer->start();
+}
+
+void TicketQueueDialog::applyFilter()
+{
+    TicketListModel::Filter filter;
+    filter.status = statusBox->currentData().toString();
+    filter.user   = userEdit->text().trimmed();
+    if (fromEdit->date() != fromEdit->minimumDate())
+        filter.from = fromEdit->date();
+    if (toEdit->date() != toEdit->minimumDate())
+        filter.to = toEdit->date();
+    m_model->setFilter(filter);
+}
+
+void TicketQueueDialog::resolveSelected()
+{
+    const QModelIndexList rows =
+        ticketView->selectionModel()->selectedRows(TicketListModel::IdColumn);
+    QVector<qint64> ids;
+    ids.reserve(rows.size());
+    for (const QModelIndex &index : rows) {
+        const qint64 id = m_model->idAt(index.row());
+        if (id > 0)
+            ids.append(id);
+    }
+    if (ids.isEmpty())
+        return;
+
+    const int resolved = m_tickets.resolveMany(ids);
+    if (resolved < 0) {
+        QMessageBox::warning(this, "Tickets",
+                             "Could not resolve the tickets:\n" + m_tickets.lastError());
+        return;
+    }
+
+    m_model->refresh();
+    updateOpenCount();
+    if (resolved < ids.size()) {
+        QMessageBox::information(this, "Tickets",
+                                 QString("%1 ticket(s) resolved; %2 were already resolved.")
+                                     .arg(resolved).arg(ids.size() - resolved));
+    }
+}
+
+void TicketQueueDialog::pollOpenCount()
+{
+    QSqlQuery query(m_db->database());
+    if (!query.exec("PRAGMA data_version") || !query.next())
+        return;
+    const qint64 version = query.value(0).toLongLong();
+    if (version == m_dataVersion)
+        return;
+    m_dataVersion = version;
+    updateOpenCount();
+}
+
+void TicketQueueDialog::updateOpenCount()
+{
+    const qint64 open = m_tickets.openCount();
+    openCountLabel->setText(open < 0 ? QString("Open tickets: ?")
+                                     : QString("Open tickets: %1").arg(open));
+}
@@ -0,0 +1,54 @@
+#ifndef TICKETQUEUEDIALOG_H
+#define TICKETQUEUEDIALOG_H
+
+#include <QDialog>
+
+#include "ticketstore.h"
+
+class QComboBox;
+class QDateEdit;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QTableView;
+class QTimer;
+class TicketListModel;
+
+// Admin queue of support tickets: a lazily paged table filtered in SQL by
+// status, user and date, bulk resolve of the selected rows, and an open
+// ticket count that follows changes made by other connections.
+class TicketQueueDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // db is owned by the caller and outlives the dialog
+    explicit TicketQueueDialog(DatabaseService *db, QWidget *parent = nullptr);
+    ~TicketQueueDialog() override = default;
+
+private slots:
+    void applyFilter();
+    void resolveSelected();
+    void pollOpenCount();
+
+private:
+    DatabaseService *m_db;
+    TicketStore      m_tickets;
+    TicketListModel *m_model;
+
+    QComboBox   *statusBox;
+    QLineEdit   *userEdit;
+    QDateEdit   *fromEdit;
+    QDateEdit   *toEdit;
+    QTableView  *ticketView;
+    QPushButton *resolveButton;
+    QLabel      *openCountLabel;
+    QTimer      *filterTimer;     // debounces userEdit
+    QTimer      *pollTimer;
+
+    qint64 m_dataVersion = -1;
+
+    void updateOpenCount();
+};
+
+#endif // TICKETQUEUEDIALOG_H
@@ -0,0 +1,192 @@
+#include "ticketstore.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTextStream>
+#include <QVariant>
+
+TicketStore::TicketStore(DatabaseService *db)
+    : m_db(db)
+{
+}
+
+qint64 TicketStore::raise(const QString &user, const QString &subject,
+                          const QString &message)
+{
+    QSqlQuery &query = m_db->statement(DatabaseService::InsertTicket);
+    query.bindValue(":user", user);
+    query.bindValue(":subject", subject);
+    query.bindValue(":message", message);
+    query.bindValue(":created", QDateTime::currentSecsSinceEpoch());
+    if (!m_db->exec(DatabaseService::InsertTicket)) {
+        m_error = query.lastError().text();
+        return -1;
+    }
+    return query.lastInsertId().toLongLong();
+}
+
+bool TicketStore::resolve(qint64 id)
+{
+    QSqlQuery &query = m_db->statement(DatabaseService::ResolveTicket);
+    query.bindValue(":resolved", QDateTime::currentSecsSinceEpoch());
+    query.bindValue(":id", id);
+    if (!m_db->exec(DatabaseService::ResolveTicket)) {
+        m_error = query.lastError().text();
+        return false;
+    }
+    if (query.numRowsAffected() != 1) {
+        m_error = QString("Ticket %1 is not open.").arg(id);
+        return false;
+    }
+    return true;
+}
+
+int TicketStore::resolveMany(const QVector<qint64> &ids)
+{
+    QSqlDatabase db = m_db->database();
+    if (!db.transaction()) {
+        m_error = db.lastError().text();
+        return -1;
+    }
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    int resolved = 0;
+    for (qint64 id : ids) {
+        QSqlQuery &query = m_db->statement(DatabaseService::ResolveTicket);
+        query.bindValue(":resolved", now);
+        query.bindValue(":id", id);
+        if (!m_db->exec(DatabaseService::ResolveTicket)) {
+            m_error = query.lastError().text();
+            db.rollback();
+            return -1;
+        }
+        resolved += query.numRowsAffected();
+    }
+
+    if (!db.commit()) {
+        m_error = db.lastError().text();
+        db.rollback();
+        return -1;
+    }
+    return resolved;
+}
+
+qint64 TicketStore::openCount()
+{
+    QSqlQuery &query = m_db->statement(DatabaseService::CountOpenTickets);
+    if (!m_db->exec(DatabaseService::CountOpenTickets) || !query.next()) {
+        m_error = query.lastError().text();
+        return -1;
+    }
+    const qint64 count = query.value(0).toLongLong();
+    query.finish();
+    return count;
+}
+
+QVector<TicketStore::Ticket> TicketStore::ticketsFor(const QString &user)
+{
+    m_db->statement(DatabaseService::SelectUserTickets).bindValue(":user", user);
+    return readTickets(DatabaseService::SelectUserTickets);
+}
+
+// statement has been bound; columns are id, user, subject, message,
+// status, created_at
+QVector<TicketStore::Ticket> TicketStore::readTickets(DatabaseService::Statement s)
+{
+    QVector<Ticket> tickets;
+    QSqlQuery &query = m_db->statement(s);
+    if (!m_db->exec(s)) {
+        m_error = query.lastError().text();
+        return tickets;
+    }
+    while (query.next()) {
+        Ticket t;
+        t.id        = query.value(0).toLongLong();
+        t.user      = query.value(1).toString();
+        t.subject   = query.value(2).toString();
+        t.message   = query.value(3).toString();
+        t.status    = query.value(4).toString();
+        t.createdAt = QDateTime::fromSecsSinceEpoch(query.value(5).toLongLong());
+        tickets.append(t);
+    }
+    query.finish();
+    return tickets;
+}
+
+int TicketStore::importLegacyFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.exists())
+        return 0;
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_error = "Cannot open " + path + ": " + file.errorString();
+        return -1;
+    }
+    // the old format kept no timestamps; the file's age is the best guess
+    const qint64 created = QFileInfo(file).lastModified().toSecsSinceEpoch();
+
+    QSqlDatabase db = m_db->database();
+    if (!db.transaction()) {
+        m_error = db.lastError().text();
+        return -1;
+    }
+    QSqlQuery insert(db);
+    if (!insert.prepare("INSERT INTO tickets (user, subject, message, status, created_at, resolved_at) "
+                        "VALUES (:user, :subject, :message, :status, :created, :resolved)")) {
+        m_error = insert.lastError().text();
+        db.rollback();
+        return -1;
+    }
+
+    // "id user subject message status", space separated; subject and message
+    // could themselves contain spaces, so only a two-word middle is split
+    int moved = 0;
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QStringList parts = in.readLine().simplified().split(' ', Qt::SkipEmptyParts);
+        if (parts.size() < 3)
+            continue;
+        const QString user = parts.at(1);
+        QString status = "open";
+        if (parts.size() >= 4 && (parts.last() == "open" || parts.last() == "cleared")) {
+            status = parts.last() == "cleared" ? "resolved" : "open";
+            parts.removeLast();
+        }
+        // message is NOT NULL, and a null QString would bind as NULL
+        const QStringList middle = parts.mid(2);
+        const QString subject = middle.size() == 2 ? middle.at(0) : middle.join(' ');
+        const QString message = middle.size() == 2 ? middle.at(1) : QString("");
+
+        insert.bindValue(":user", user);
+        insert.bindValue(":subject", subject);
+        insert.bindValue(":message", message);
+        insert.bindValue(":status", status);
+        insert.bindValue(":created", created);
+        insert.bindValue(":resolved", status == "resolved" ? QVariant(created) : QVariant());
+        if (!insert.exec()) {
+            m_error = insert.lastError().text();
+            db.rollback();
+            return -1;
+        }
+        ++moved;
+    }
+    file.close();
+
+    if (!db.commit()) {
+        m_error = db.lastError().text();
+        db.rollback();
+        return -1;
+    }
+
+    // the rows are in; a file left behind would be imported again
+    const QString migrated = path + ".migrated";
+    QFile::remove(migrated);
+    if (!QFile::rename(path, migrated)) {
+        m_error = QString("%1 ticket(s) were moved to the database, but %2 could "
+                          "not be renamed; remove it by hand.").arg(moved).arg(path);
+        return -1;
+    }
+    return moved;
+}
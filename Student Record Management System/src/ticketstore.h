@@ -0,0 +1,59 @@
+#ifndef TICKETSTORE_H
+#define TICKETSTORE_H
+
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+
+#include "databaseservice.h"
+
+// Support tickets raised by students, kept in the tickets table. Every
+// operation is a single indexed statement run through the service's
+// prepared-statement cache; nothing loads the whole table.
+class TicketStore
+{
+public:
+    struct Ticket {
+        qint64    id = 0;
+        QString   user;
+        QString   subject;
+        QString   message;
+        QString   status;       // "open" or "resolved"
+        QDateTime createdAt;
+    };
+
+    // db is owned by the caller and outlives the store
+    explicit TicketStore(DatabaseService *db);
+
+    // new ticket id, or -1 on failure
+    qint64 raise(const QString &user, const QString &subject, const QString &message);
+
+    // false if the ticket does not exist or was already resolved
+    bool resolve(qint64 id);
+
+    // resolves every still-open ticket in ids in one transaction; returns
+    // how many changed, or -1 (and nothing changed) on failure
+    int resolveMany(const QVector<qint64> &ids);
+
+    // -1 on failure
+    qint64 openCount();
+
+    // newest first
+    QVector<Ticket> ticketsFor(const QString &user);
+
+    // Moves a tickets.txt written by older versions into the table in one
+    // transaction and renames it to "<path>.migrated". Returns the number
+    // of tickets moved (0 if there is no file) or -1 on failure, in which
+    // case the file is left in place for the next start.
+    int importLegacyFile(const QString &path);
+
+    QString lastError() const { return m_error; }
+
+private:
+    DatabaseService *m_db;
+    QString m_error;
+
+    QVector<Ticket> readTickets(DatabaseService::Statement s);
+};
+
+#endif // TICKETSTORE_H
@@ -0,0 +1,170 @@
+// In-memory stand-in for the central sync server, for trying SyncClient
+// locally. Speaks the protocol described in syncclient.h over plain
+// HTTP/1.1, one request per connection, and like the real thing keeps
+// only the winning change per roll number (SyncChange::supersedes()).
+// Nothing is written to disk; restarting it starts from an empty log.
+// Usage: StudentMockSyncServer [--port 8765]
+//   then StudentRecordManager --sync http://127.0.0.1:8765/ on each copy
+
+#include "syncclient.h"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUrl>
+#include <QUrlQuery>
+
+#include <cstdio>
+#include <map>
+
+namespace {
+
+class MockSyncServer : public QObject
+{
+public:
+    bool listen(quint16 port)
+    {
+        connect(&m_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { read(socket); });
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+        return m_server.listen(QHostAddress::LocalHost, port);
+    }
+
+    QString errorString() const { return m_server.errorString(); }
+
+private:
+    QTcpServer m_server;
+    std::map<qint64, SyncChange> m_log;   // by seq, winners only
+    QHash<QString, qint64> m_latest;      // rollno -> seq in m_log
+    qint64 m_seq = 0;
+
+    // waits for the headers and Content-Length bytes of body
+    void read(QTcpSocket *socket)
+    {
+        QByteArray buffer = socket->property("buffer").toByteArray() + socket->readAll();
+        socket->setProperty("buffer", buffer);
+
+        const int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0)
+            return;
+        const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+        const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+        if (requestLine.size() < 2) {
+            respond(socket, 400, QJsonObject{ { "error", "bad request line" } });
+            return;
+        }
+        qsizetype length = 0;
+        for (const QByteArray &line : lines) {
+            if (line.toLower().startsWith("content-length:"))
+                length = line.mid(15).trimmed().toLongLong();
+        }
+        if (buffer.size() < headerEnd + 4 + length)
+            return;
+
+        const QByteArray method = requestLine.at(0);
+        const QUrl url(QString::fromLatin1(requestLine.at(1)));
+        const QByteArray body = buffer.mid(headerEnd + 4, length);
+
+        if (method == "POST" && url.path().endsWith("/push"))
+            respond(socket, 200, push(QJsonDocument::fromJson(body).object()));
+        else if (method == "GET" && url.path().endsWith("/pull"))
+            respond(socket, 200, pull(QUrlQuery(url)));
+        else
+            respond(socket, 404, QJsonObject{ { "error", "no such endpoint" } });
+    }
+
+    void respond(QTcpSocket *socket, int status, const QJsonObject &answer)
+    {
+        const QByteArray body = QJsonDocument(answer).toJson(QJsonDocument::Compact);
+        QByteArray head = "HTTP/1.1 " + QByteArray::number(status) +
+                          (status == 200 ? " OK" : status == 404 ? " Not Found" : " Bad Request");
+        head += "\r\nContent-Type: application/json\r\nContent-Length: " +
+                QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n";
+        socket->write(head + body);
+        socket->disconnectFromHost();
+    }
+
+    QJsonObject push(const QJsonObject &request)
+    {
+        const QJsonArray changes = request["changes"].toArray();
+        int accepted = 0;
+        QJsonArray rejected;   // the winner, for each change that lost
+        for (const QJsonValue &v : changes) {
+            SyncChange c = SyncChange::fromJson(v.toObject());
+            if (c.rollNo.isEmpty()) {   // nothing to keep; dropped
+                ++accepted;
+                continue;
+            }
+            const auto known = m_latest.constFind(c.rollNo);
+            if (known != m_latest.constEnd()) {
+                const SyncChange &winner = m_log.at(*known);
+                if (!c.supersedes(winner)) {
+                    rejected.append(winner.toJson());
+                    continue;
+                }
+                m_log.erase(*known);
+            }
+            c.seq = ++m_seq;
+            m_log.emplace(c.seq, c);
+            m_latest.insert(c.rollNo, c.seq);
+            ++accepted;
+        }
+        std::printf("push  %-16s %d of %lld accepted, seq %lld\n",
+                    qPrintable(request["site"].toString()), accepted,
+                    static_cast<long long>(changes.size()), static_cast<long long>(m_seq));
+        std::fflush(stdout);
+        return QJsonObject{ { "accepted", accepted }, { "rejected", rejected } };
+    }
+
+    QJsonObject pull(const QUrlQuery &query)
+    {
+        const qint64 since = query.queryItemValue("since").toLongLong();
+        const QString site = query.queryItemValue("site");
+        const int limit = qBound(1, query.queryItemValue("limit").toInt(), 10000);
+
+        QJsonArray changes;
+        qint64 last = since;
+        auto it = m_log.upper_bound(since);
+        for (; it != m_log.end() && changes.size() < limit; ++it) {
+            last = it->first;
+            if (it->second.site != site)
+                changes.append(it->second.toJson());
+        }
+        std::printf("pull  %-16s since %lld: %lld change(s)\n", qPrintable(site),
+                    static_cast<long long>(since), static_cast<long long>(changes.size()));
+        std::fflush(stdout);
+        return QJsonObject{ { "changes", changes },
+                            { "last", last },
+                            { "more", it != m_log.end() } };
+    }
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    quint16 port = 8765;
+    const QStringList args = app.arguments();
+    for (int i = 1; i + 1 < args.size(); ++i) {
+        if (args.at(i) == "--port")
+            port = quint16(args.at(i + 1).toUInt());
+    }
+
+    MockSyncServer server;
+    if (!server.listen(port)) {
+        std::fprintf(stderr, "cannot listen on port %u: %s\n", port,
+                     qPrintable(server.errorString()));
+        return 1;
+    }
+    std::printf("mock sync server on http://127.0.0.1:%u/\n", port);
+    std::fflush(stdout);
+    return app.exec();
+}
@@ -0,0 +1,290 @@
+// Drives MainWindow through scripted play sessions with synthetic QTest input
+// and reports, per board size and interaction, the latency from input to the
+// board's next repaint plus the heap allocations made on the way.
+// Runs headless: QT_QPA_PLATFORM defaults to offscreen.
+// Usage: SudokuGuiBench [rounds] [moves-per-round]
+
+#include "MainWindow.h"
+
+#include <QApplication>
+#include <QComboBox>
+#include <QFile>
+#include <QPushButton>
+#include <QStandardPaths>
+#include <QTableWidget>
+#include <QTest>
+#include <QTimer>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+// ---------------- allocation counting ----------------
+
+namespace {
+std::atomic<unsigned long long> allocations{0};
+}
+
+// array and nothrow forms route through these by default
+void *operator new(std::size_t n) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// ---------------- measurement ----------------
+
+enum Interaction { NewGame, Move, WrongMove, Undo, Redo, Solve, InteractionCount };
+
+const char *const InteractionNames[InteractionCount] = {
+    "new game", "move", "wrong move", "undo", "redo", "solve",
+};
+
+const int Sizes[] = {6, 9, 12};
+const char *const Difficulties[] = {"Easy", "Medium", "Hard"};
+
+struct Samples {
+    std::vector<double> us;
+    unsigned long long allocs = 0;
+};
+
+Samples results[3][InteractionCount];
+int missedPaints = 0;
+bool modalShown = false;   // set by the dismiss timer in main()
+
+// flags any paint on the watched widget
+class PaintProbe : public QObject {
+public:
+    bool painted = false;
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *ev) override {
+        if (ev->type() == QEvent::Paint) painted = true;
+        return QObject::eventFilter(obj, ev);
+    }
+};
+
+PaintProbe *probe = nullptr;
+
+// runs action, then spins the event loop until the board has repainted;
+// an interaction that ends in a (dismissed) message box counts as done
+template <typename Action>
+void measure(int sizeIndex, Interaction kind, Action action) {
+    using Clock = std::chrono::steady_clock;
+    QCoreApplication::processEvents();   // settle anything left over
+    probe->painted = false;
+    modalShown = false;
+
+    const unsigned long long a0 = allocations.load(std::memory_order_relaxed);
+    const auto t0 = Clock::now();
+    action();
+    const auto deadline = t0 + std::chrono::seconds(1);
+    while (!probe->painted && !modalShown && Clock::now() < deadline)
+        QCoreApplication::processEvents(QEventLoop::AllEvents);
+    const auto t1 = Clock::now();
+    const unsigned long long a1 = allocations.load(std::memory_order_relaxed);
+
+    if (!probe->painted && !modalShown) ++missedPaints;
+    Samples &s = results[sizeIndex][kind];
+    s.us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+    s.allocs += a1 - a0;
+}
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t rank = static_cast<size_t>(p * static_cast<double>(v.size()));
+    return v[std::min(rank, v.size() - 1)];
+}
+
+// ---------------- board helpers ----------------
+
+int cellAt(const QTableWidget *table, int r, int c) {
+    const QTableWidgetItem *item = table->item(r, c);
+    return item ? item->text().toInt() : 0;
+}
+
+// digits a peer of (r, c) already shows, as a mask with bit v for digit v
+uint16_t peerMask(const QTableWidget *table, int size, int r, int c) {
+    const int boxRows = (size == 9) ? 3 : (size == 6 ? 2 : 3);
+    const int boxCols = size / boxRows;
+    uint16_t mask = 0;
+    for (int i = 0; i < size; ++i) {
+        mask |= static_cast<uint16_t>(1u << cellAt(table, r, i));
+        mask |= static_cast<uint16_t>(1u << cellAt(table, i, c));
+    }
+    const int br = r / boxRows * boxRows;
+    const int bc = c / boxCols * boxCols;
+    for (int i = br; i < br + boxRows; ++i)
+        for (int j = bc; j < bc + boxCols; ++j)
+            mask |= static_cast<uint16_t>(1u << cellAt(table, i, j));
+    return static_cast<uint16_t>(mask & ~1u);
+}
+
+// type the digits into (r, c) the way a player would and commit with Return
+void typeValue(QTableWidget *table, int r, int c, int val) {
+    table->setFocus();
+    table->setCurrentCell(r, c);
+    const QByteArray text = QByteArray::number(val);
+
+    // the first key opens the editor (AllEditTriggers); the rest go to it
+    QTest::keyClick(table, text.at(0));
+    QWidget *editor = table->focusWidget();
+    if (!editor) editor = table;
+    for (int i = 1; i < text.size(); ++i)
+        QTest::keyClick(editor, text.at(i));
+    QTest::keyClick(editor, Qt::Key_Return);
+}
+
+int pickDigit(uint16_t mask, std::mt19937 &rng) {
+    int digits[SudokuEngine::MaxSize];
+    int n = 0;
+    for (int v = 1; v <= SudokuEngine::MaxSize; ++v)
+        if (mask & (1u << v)) digits[n++] = v;
+    return n ? digits[rng() % static_cast<unsigned>(n)] : 0;
+}
+
+// ---------------- scripted session ----------------
+
+void playRound(MainWindow &w, int sizeIndex, int moves, std::mt19937 &rng) {
+    auto *difficulty = w.findChild<QComboBox *>("difficultyBox");
+    auto *table = w.findChild<QTableWidget *>("board");
+    auto *newGame = w.findChild<QPushButton *>("newGameButton");
+    auto *solve = w.findChild<QPushButton *>("solveButton");
+    auto *undo = w.findChild<QPushButton *>("undoButton");
+    auto *redo = w.findChild<QPushButton *>("redoButton");
+
+    const int size = Sizes[sizeIndex];
+    difficulty->setCurrentText(Difficulties[sizeIndex]);
+    measure(sizeIndex, NewGame, [&] { QTest::mouseClick(newGame, Qt::LeftButton); });
+
+    const uint16_t full = static_cast<uint16_t>(((1u << size) - 1) << 1);
+    int wrong[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    int made = 0;
+
+    for (int i = 0; i < moves; ++i) {
+        // random open cell that still has a legal digit
+        int open[SudokuEngine::MaxSize * SudokuEngine::MaxSize];
+        int n = 0;
+        for (int r = 0; r < size; ++r)
+            for (int c = 0; c < size; ++c)
+                if (cellAt(table, r, c) == 0 &&
+                    (table->item(r, c)->flags() & Qt::ItemIsEditable) &&
+                    (full & ~peerMask(table, size, r, c)))
+                    open[n++] = r * SudokuEngine::MaxSize + c;
+        if (n == 0) break;
+
+        const int cell = open[rng() % static_cast<unsigned>(n)];
+        const int r = cell / SudokuEngine::MaxSize;
+        const int c = cell % SudokuEngine::MaxSize;
+        const uint16_t peers = peerMask(table, size, r, c);
+
+        // every sixth move is a clash; stay well clear of the game-over limit
+        if (i % 6 == 5 && peers && wrong[r][c] < 2) {
+            ++wrong[r][c];
+            const int val = pickDigit(peers, rng);
+            measure(sizeIndex, WrongMove, [&] { typeValue(table, r, c, val); });
+        } else {
+            const int val = pickDigit(full & ~peers, rng);
+            measure(sizeIndex, Move, [&] { typeValue(table, r, c, val); });
+            ++made;
+        }
+    }
+
+    const int steps = std::min(made, 8);
+    for (int i = 0; i < steps; ++i)
+        measure(sizeIndex, Undo, [&] { QTest::mouseClick(undo, Qt::LeftButton); });
+    for (int i = 0; i < steps; ++i)
+        measure(sizeIndex, Redo, [&] { QTest::mouseClick(redo, Qt::LeftButton); });
+
+    measure(sizeIndex, Solve, [&] { QTest::mouseClick(solve, Qt::LeftButton); });
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("SudokuGuiBench");
+    QStandardPaths::setTestModeEnabled(true);   // keep the real autosave out of it
+
+    int rounds = (argc > 1) ? std::atoi(argv[1]) : 5;
+    int moves = (argc > 2) ? std::atoi(argv[2]) : 40;
+    if (rounds < 1) rounds = 1;
+    if (moves < 1) moves = 1;
+
+    const QString dataDir =
+        QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    QFile::remove(dataDir + "/autosave.sdks");
+
+    // "no solution" and "game over" boxes are modal; dismiss them as they pop
+    QTimer dismiss;
+    QObject::connect(&dismiss, &QTimer::timeout, [] {
+        if (QWidget *modal = QApplication::activeModalWidget()) {
+            modalShown = true;
+            modal->close();
+        }
+    });
+    dismiss.start(5);
+
+    MainWindow w;
+    w.show();
+    w.activateWindow();
+    if (!QTest::qWaitForWindowExposed(&w)) {
+        std::fprintf(stderr, "window never exposed\n");
+        return 1;
+    }
+
+    auto *table = w.findChild<QTableWidget *>("board");
+    auto *start = w.findChild<QPushButton *>("startButton");
+    if (!table || !start || !w.findChild<QComboBox *>("difficultyBox")) {
+        std::fprintf(stderr, "MainWindow widgets not found\n");
+        return 1;
+    }
+
+    PaintProbe paintProbe;
+    probe = &paintProbe;
+    table->viewport()->installEventFilter(&paintProbe);
+
+    QTest::mouseClick(start, Qt::LeftButton);
+    QTest::qWait(50);
+
+    std::mt19937 rng(12345);
+    for (int round = 0; round < rounds; ++round)
+        for (int s = 0; s < 3; ++s)
+            playRound(w, s, moves, rng);
+
+    std::printf("%-6s %-12s %6s %10s %10s %10s %10s %10s\n",
+                "size", "interaction", "n", "p50 (us)", "p90 (us)",
+                "p99 (us)", "max (us)", "allocs/op");
+    for (int s = 0; s < 3; ++s) {
+        for (int k = 0; k < InteractionCount; ++k) {
+            const Samples &smp = results[s][k];
+            if (smp.us.empty()) continue;
+            const double n = static_cast<double>(smp.us.size());
+            std::printf("%2dx%-3d %-12s %6zu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+                        Sizes[s], Sizes[s], InteractionNames[k], smp.us.size(),
+                        percentile(smp.us, 0.50), percentile(smp.us, 0.90),
+                        percentile(smp.us, 0.99), percentile(smp.us, 1.0),
+                        static_cast<double>(smp.allocs) / n);
+        }
+    }
+
+    if (missedPaints > 0) {
+        std::printf("\n%d interaction(s) never repainted the board\n", missedPaints);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Fills a SessionManager with many concurrent games and times moves
+// against them in batches.
+// Usage: SudokuSessionBench [sessions] [moves]
+
+#include "SessionManager.h"
+#include "SudokuEngine.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr int PuzzlesPerSize = 8;
+constexpr size_t BatchSize = 256;
+
+struct Puzzle {
+    int size;
+    uint8_t cells[SudokuEngine::MaxSize * SudokuEngine::MaxSize];
+    uint8_t solution[SudokuEngine::MaxSize * SudokuEngine::MaxSize];
+};
+
+std::vector<Puzzle> makePuzzles() {
+    std::vector<Puzzle> puzzles;
+    SudokuEngine engine;
+    int grid[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    for (int size : {6, 9, 12}) {
+        for (int i = 0; i < PuzzlesPerSize; ++i) {
+            Puzzle p{};
+            p.size = size;
+            engine.generate(size, static_cast<uint32_t>(size * 1000 + i + 1), size * size / 2);
+            engine.getGrid(grid);
+            for (int c = 0; c < size * size; ++c)
+                p.cells[c] = static_cast<uint8_t>(grid[c / size][c % size]);
+            engine.solve(size);
+            engine.getGrid(grid);
+            for (int c = 0; c < size * size; ++c)
+                p.solution[c] = static_cast<uint8_t>(grid[c / size][c % size]);
+            puzzles.push_back(p);
+        }
+    }
+    return puzzles;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const long sessions = (argc > 1) ? std::atol(argv[1]) : 100000;
+    const long moves = (argc > 2) ? std::atol(argv[2]) : 2000000;
+    if (sessions < 1 || moves < 1) return 1;
+
+    const std::vector<Puzzle> puzzles = makePuzzles();
+
+    SessionManager manager;
+    std::vector<SessionManager::SessionId> ids(static_cast<size_t>(sessions));
+    std::vector<int> puzzleOf(static_cast<size_t>(sessions));
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (long i = 0; i < sessions; ++i) {
+        const int p = static_cast<int>(i % static_cast<long>(puzzles.size()));
+        puzzleOf[i] = p;
+        ids[i] = manager.create(puzzles[p].cells, puzzles[p].size);
+        if (ids[i] == SessionManager::InvalidSession) {
+            std::fprintf(stderr, "create failed for puzzle %d\n", p);
+            return 1;
+        }
+    }
+    const double createSec = secondsSince(t0);
+
+    // mostly correct digits, one in eight drawn at random
+    std::vector<SessionManager::Request> reqs(BatchSize);
+    std::vector<SessionManager::Reply> replies(BatchSize);
+    long counts[8]{};
+    uint32_t rng = 0x2545f491u;
+
+    t0 = std::chrono::steady_clock::now();
+    for (long done = 0; done < moves; done += static_cast<long>(BatchSize)) {
+        for (SessionManager::Request &req : reqs) {
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+            const long s = static_cast<long>(rng % static_cast<uint32_t>(sessions));
+            const Puzzle &p = puzzles[puzzleOf[s]];
+            const int cell = static_cast<int>((rng >> 8) % static_cast<uint32_t>(p.size * p.size));
+            req.session = ids[s];
+            req.op = SessionManager::Op::Place;
+            req.cell = static_cast<uint8_t>(cell);
+            req.value = (rng & 7) ? p.solution[cell]
+                                  : static_cast<uint8_t>(1 + (rng >> 4) % static_cast<uint32_t>(p.size));
+        }
+        manager.handle(reqs.data(), replies.data(), reqs.size());
+        for (const SessionManager::Reply &r : replies)
+            ++counts[static_cast<int>(r.status)];
+    }
+    const double moveSec = secondsSince(t0);
+    const long handled = (moves + static_cast<long>(BatchSize) - 1) /
+                         static_cast<long>(BatchSize) * static_cast<long>(BatchSize);
+
+    // closing and reopening half the sessions reuses slab slots
+    t0 = std::chrono::steady_clock::now();
+    for (long i = 0; i < sessions; i += 2) manager.close(ids[i]);
+    for (long i = 0; i < sessions; i += 2)
+        ids[i] = manager.create(puzzles[puzzleOf[i]].cells, puzzles[puzzleOf[i]].size);
+    const double churnSec = secondsSince(t0);
+
+    std::printf("sessions          %u\n", manager.sessions());
+    std::printf("bytes reserved    %zu (%.1f per session)\n", manager.bytesReserved(),
+                static_cast<double>(manager.bytesReserved()) / static_cast<double>(sessions));
+    std::printf("create            %.1f ns/session\n", createSec * 1e9 / static_cast<double>(sessions));
+    std::printf("moves             %.1f ns/move (%ld moves)\n",
+                moveSec * 1e9 / static_cast<double>(handled), handled);
+    std::printf("close + recreate  %.1f ns/session\n",
+                churnSec * 1e9 / static_cast<double>(sessions));
+    std::printf("replies           ok %ld, wrong %ld, game over %ld, completed %ld, finished %ld\n",
+                counts[static_cast<int>(SessionManager::Status::Ok)],
+                counts[static_cast<int>(SessionManager::Status::Wrong)],
+                counts[static_cast<int>(SessionManager::Status::GameOver)],
+                counts[static_cast<int>(SessionManager::Status::Completed)],
+                counts[static_cast<int>(SessionManager::Status::Finished)]);
+    return 0;
+}
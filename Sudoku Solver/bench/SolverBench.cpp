@@ -0,0 +1,249 @@
+// Times the SudokuEngine backends against each other on a set of hard grids,
+// then times killer grids, which always go through the mask search.
+// Usage: SudokuSolverBench [repeats]
+
+#include "SudokuEngine.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct BenchGrid {
+    const char *name;
+    int size;
+    const char *cells;   // row-major, '.' for empty, 1-9 then A-C for 10-12
+};
+
+const BenchGrid Grids[] = {
+    {"easy 6x6", 6,
+     "1..4.."
+     "..6..3"
+     ".3..6."
+     "5..2.."
+     "..2..5"
+     "6..3.."},
+    {"medium 9x9", 9,
+     "53..7...."
+     "6..195..."
+     ".98....6."
+     "8...6...3"
+     "4..8.3..1"
+     "7...2...6"
+     ".6....28."
+     "...419..5"
+     "....8..79"},
+    {"ai escargot", 9,
+     "1....7.9."
+     ".3..2...8"
+     "..96..5.."
+     "..53..9.."
+     ".1..8...2"
+     "6....4..."
+     "3......1."
+     ".4......7"
+     "..7...3.."},
+    {"inkala 2012", 9,
+     "8........"
+     "..36....."
+     ".7..9.2.."
+     ".5...7..."
+     "....457.."
+     "...1...3."
+     "..1....68"
+     "..85...1."
+     ".9....4.."},
+    {"golden nugget", 9,
+     ".......39"
+     ".....1..5"
+     "..3.5.8.."
+     "..8.9...6"
+     ".7...2..."
+     "1..4....."
+     "..9.8..5."
+     ".2....6.."
+     "4..7....."},
+    {"easter monster", 9,
+     "1.......2"
+     ".9.4...5."
+     "..6...7.."
+     ".5.9.3..."
+     "....7...."
+     "...85..4."
+     "7.....6.."
+     ".3...9.8."
+     "..2.....1"},
+    {"hard 12x12", 12,
+     "1...9...C..6"
+     ".C...6.3..9."
+     "..9..C...4.."
+     "...6..B....A"
+     "..C....9..4."
+     ".5..3...7..."
+     "...8...1.B.."
+     ".4..B...2..."
+     "B....8....6."
+     "..6...9..3.."
+     ".8...5.A..2."
+     "4..C....9..1"},
+};
+
+// No givens at all: the cages alone pin down the grid. Sums are taken from
+// the reference solution so the layout string stays readable.
+struct KillerGrid {
+    const char *name;
+    int size;
+    const char *cages;      // row-major cage labels, one char per cell
+    const char *solution;
+};
+
+const KillerGrid Killers[] = {
+    {"killer 9x9", 9,
+     "aaabbcdde"
+     "fgbbhcide"
+     "fggjhkill"
+     "mmmjnkkop"
+     "qqqnnrrop"
+     "sstuvvwwp"
+     "xstuuvwyz"
+     "xxAAuBCyz"
+     "DxAEEBByz",
+     "534678912"
+     "672195348"
+     "198342567"
+     "859761423"
+     "426853791"
+     "713924856"
+     "961537284"
+     "287419635"
+     "345286179"},
+};
+
+int cellValue(char ch) {
+    if (ch >= '1' && ch <= '9') return ch - '0';
+    if (ch >= 'A' && ch <= 'C') return ch - 'A' + 10;
+    return 0;
+}
+
+bool isValidSolution(const int g[SudokuEngine::MaxSize][SudokuEngine::MaxSize],
+                     int size) {
+    const int boxRows = (size == 9) ? 3 : (size == 6 ? 2 : 3);
+    const int boxCols = size / boxRows;
+    for (int i = 0; i < size; ++i) {
+        bool row[SudokuEngine::MaxSize + 1]{};
+        bool col[SudokuEngine::MaxSize + 1]{};
+        bool box[SudokuEngine::MaxSize + 1]{};
+        for (int j = 0; j < size; ++j) {
+            int rv = g[i][j];
+            int cv = g[j][i];
+            int bv = g[(i / (size / boxCols)) * boxRows + j / boxCols]
+                      [(i % (size / boxCols)) * boxCols + j % boxCols];
+            if (rv < 1 || rv > size || row[rv]) return false;
+            if (cv < 1 || cv > size || col[cv]) return false;
+            if (bv < 1 || bv > size || box[bv]) return false;
+            row[rv] = col[cv] = box[bv] = true;
+        }
+    }
+    return true;
+}
+
+// best-of-N wall time in microseconds, or -1 if the backend failed
+double timeBackend(const BenchGrid &bg, SudokuEngine::Backend backend,
+                   int repeats) {
+    int src[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    for (int i = 0; i < bg.size * bg.size; ++i)
+        src[i / bg.size][i % bg.size] = cellValue(bg.cells[i]);
+
+    double best = -1.0;
+    for (int rep = 0; rep < repeats; ++rep) {
+        SudokuEngine engine;
+        engine.setBackend(backend);
+        engine.loadPuzzle(src, bg.size);
+
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = engine.solve(bg.size);
+        auto t1 = std::chrono::steady_clock::now();
+
+        int out[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+        engine.getGrid(out);
+        if (!ok || !isValidSolution(out, bg.size)) return -1.0;
+
+        double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        if (best < 0 || us < best) best = us;
+    }
+    return best;
+}
+
+std::vector<SudokuEngine::Cage> killerCages(const KillerGrid &kg) {
+    std::vector<SudokuEngine::Cage> cages;
+    int index[128];
+    std::memset(index, -1, sizeof(index));
+    for (int i = 0; i < kg.size * kg.size; ++i) {
+        unsigned char label = static_cast<unsigned char>(kg.cages[i]);
+        if (index[label] < 0) {
+            index[label] = static_cast<int>(cages.size());
+            cages.emplace_back();
+        }
+        SudokuEngine::Cage &cage = cages[index[label]];
+        cage.sum += cellValue(kg.solution[i]);
+        cage.cells.push_back((i / kg.size) * SudokuEngine::MaxSize + i % kg.size);
+    }
+    return cages;
+}
+
+double timeKiller(const KillerGrid &kg, int repeats) {
+    const std::vector<SudokuEngine::Cage> cages = killerCages(kg);
+    const int empty[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+
+    double best = -1.0;
+    for (int rep = 0; rep < repeats; ++rep) {
+        SudokuEngine engine;
+        if (!engine.loadPuzzle(empty, kg.size, cages)) return -1.0;
+
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = engine.solve(kg.size);
+        auto t1 = std::chrono::steady_clock::now();
+
+        int out[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+        engine.getGrid(out);
+        if (!ok || !isValidSolution(out, kg.size)) return -1.0;
+        for (const SudokuEngine::Cage &cage : cages) {
+            int sum = 0;
+            for (int cell : cage.cells)
+                sum += out[cell / SudokuEngine::MaxSize][cell % SudokuEngine::MaxSize];
+            if (sum != cage.sum) return -1.0;
+        }
+
+        double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        if (best < 0 || us < best) best = us;
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int repeats = (argc > 1) ? std::atoi(argv[1]) : 3;
+    if (repeats < 1) repeats = 1;
+
+    std::printf("%-16s %16s %16s %16s\n", "grid", "backtrack (us)", "sat (us)", "masks (us)");
+    bool allOk = true;
+    for (const BenchGrid &bg : Grids) {
+        double bt    = timeBackend(bg, SudokuEngine::Backend::Backtracking, repeats);
+        double sat   = timeBackend(bg, SudokuEngine::Backend::Sat, repeats);
+        double masks = timeBackend(bg, SudokuEngine::Backend::Masks, repeats);
+        allOk = allOk && bt >= 0 && sat >= 0 && masks >= 0;
+        std::printf("%-16s %16.1f %16.1f %16.1f\n", bg.name, bt, sat, masks);
+    }
+
+    std::printf("\n%-16s %16s\n", "grid", "killer (us)");
+    for (const KillerGrid &kg : Killers) {
+        double us = timeKiller(kg, repeats);
+        allOk = allOk && us >= 0;
+        std::printf("%-16s %16.1f\n", kg.name, us);
+    }
+    return allOk ? 0 : 1;
+}
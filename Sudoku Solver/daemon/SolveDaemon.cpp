@@ -0,0 +1,539 @@
+#include "SolveDaemon.h"
+#include "SolveProtocol.h"
+#include "sudoku.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace SolveProtocol;
+
+// ---------------- constructor ----------------
+
+SolveDaemon::SolveDaemon(const Options &options)
+    : opts(options) {
+    if (opts.workers < 1) opts.workers = 1;
+    if (opts.maxBatch < 1) opts.maxBatch = 1;
+}
+
+SolveDaemon::~SolveDaemon() {
+    stopping = true;
+    for (auto &w : workers) {
+        {
+            std::lock_guard<std::mutex> lock(w->mutex);
+        }
+        w->wake.notify_all();
+    }
+    for (auto &w : workers) {
+        if (w->thread.joinable()) w->thread.join();
+    }
+
+    for (auto &entry : conns) ::close(entry.first);
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(opts.socketPath.c_str());
+    }
+    if (signalFd >= 0) ::close(signalFd);
+    if (wakeFd >= 0) ::close(wakeFd);
+    if (epollFd >= 0) ::close(epollFd);
+}
+
+// ---------------- setup ----------------
+
+bool SolveDaemon::start(std::string &error) {
+    sockaddr_un addr{};
+    if (opts.socketPath.empty() || opts.socketPath.size() >= sizeof(addr.sun_path)) {
+        error = "socket path is empty or too long";
+        return false;
+    }
+
+    // block the signals before any worker exists so only signalfd sees them
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        error = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, opts.socketPath.c_str(), opts.socketPath.size() + 1);
+    ::unlink(opts.socketPath.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listenFd, SOMAXCONN) < 0) {
+        error = opts.socketPath + ": " + std::strerror(errno);
+        return false;
+    }
+
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    signalFd = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0 || signalFd < 0) {
+        error = std::string("epoll/eventfd/signalfd: ") + std::strerror(errno);
+        return false;
+    }
+
+    for (int fd : {listenFd, wakeFd, signalFd}) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    pending.reserve(opts.maxBatch * 4);
+    done.reserve(opts.maxBatch * 4);
+    doneSwap.reserve(opts.maxBatch * 4);
+
+    for (int i = 0; i < opts.workers; ++i) {
+        auto w = std::make_unique<Worker>();
+        w->inbox.reserve(opts.maxBatch * 4);
+        // the fastest search on hard grids; a worker is pinned while it runs
+        w->engine.setBackend(SudokuEngine::Backend::Masks);
+        workers.push_back(std::move(w));
+    }
+    for (auto &w : workers) {
+        Worker *worker = w.get();
+        worker->thread = std::thread([this, worker]() { workerLoop(*worker); });
+    }
+    return true;
+}
+
+// ---------------- event loop ----------------
+
+int SolveDaemon::run() {
+    epoll_event events[64];
+
+    while (!stopping) {
+        int n = ::epoll_wait(epollFd, events, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::perror("epoll_wait");
+            return 1;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            const uint32_t what = events[i].events;
+
+            if (fd == listenFd) {
+                acceptClients();
+            } else if (fd == wakeFd) {
+                uint64_t count = 0;
+                (void)!::read(wakeFd, &count, sizeof(count));
+                drainCompletions();
+            } else if (fd == signalFd) {
+                signalfd_siginfo info{};
+                while (::read(signalFd, &info, sizeof(info)) == sizeof(info)) {
+                    if (info.ssi_signo == SIGUSR1)
+                        std::fprintf(stderr, "%s\n", statsJson().c_str());
+                    else
+                        stopping = true;
+                }
+            } else {
+                auto it = conns.find(fd);
+                if (it == conns.end()) continue;
+
+                if (what & EPOLLIN)
+                    readClient(it->second);
+                else if (what & (EPOLLERR | EPOLLHUP))
+                    closeClient(fd);
+                else if (what & EPOLLOUT)
+                    advance(it->second);
+            }
+        }
+
+        dispatchPending();
+    }
+    return 0;
+}
+
+void SolveDaemon::acceptClients() {
+    for (;;) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return;   // EAGAIN or a transient error
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            ::close(fd);
+            continue;
+        }
+
+        Connection &conn = conns[fd];
+        conn.fd = fd;
+        conn.gen = nextGen++;
+        conn.events = EPOLLIN;
+        conn.in.reserve(4096);
+    }
+}
+
+void SolveDaemon::readClient(Connection &conn) {
+    uint8_t buf[16 * 1024];
+    while (!conn.eof && conn.in.size() < ReadChunk) {
+        ssize_t n = ::recv(conn.fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            conn.in.insert(conn.in.end(), buf, buf + n);
+            continue;
+        }
+        if (n == 0) {
+            conn.eof = true;   // requests already buffered still get answers
+            break;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+
+        closeClient(conn.fd);   // hard error
+        return;
+    }
+    advance(conn);
+}
+
+// parses what the client's backlog allows, sends what is ready and closes a
+// client that has shut down once it has been answered; conn may be gone
+// afterwards
+void SolveDaemon::advance(Connection &conn) {
+    if (!parseFrames(conn) || !flush(conn)) {
+        closeClient(conn.fd);
+        return;
+    }
+    if (conn.eof && conn.jobs == 0 && conn.outPos == conn.out.size()) {
+        closeClient(conn.fd);   // a partial frame left in `in` can never finish
+        return;
+    }
+    watch(conn);
+}
+
+// reply bytes owed, counting requests still with the workers at their
+// largest reply
+size_t SolveDaemon::backlog(const Connection &conn) {
+    constexpr size_t MaxReply = 4 + HeaderSize + SudokuEngine::MaxSize * SudokuEngine::MaxSize;
+    return conn.out.size() - conn.outPos + conn.jobs * MaxReply;
+}
+
+// returns false on a framing error; the connection is dropped then
+bool SolveDaemon::parseFrames(Connection &conn) {
+    size_t pos = 0;
+    const auto now = Clock::now();
+
+    // the rest waits in `in` until the client reads some replies
+    while (conn.in.size() - pos >= 4 && backlog(conn) < MaxBacklog) {
+        const uint32_t len = readU32(&conn.in[pos]);
+        if (len < HeaderSize || len > MaxFrame) return false;
+        if (conn.in.size() - pos - 4 < len) break;
+
+        const uint8_t *body = &conn.in[pos + 4];
+        pos += 4 + len;
+
+        Job job;
+        job.id = readU64(body);
+        job.op = body[8];
+        job.size = body[9];
+        job.arg = readU16(body + 10);
+        job.fd = conn.fd;
+        job.connGen = conn.gen;
+        job.received = now;
+
+        if (job.op == Stats) {
+            queueStats(conn, job.id);
+            continue;
+        }
+
+        const bool sizeOk = job.size == 6 || job.size == 9 || job.size == 12;
+        if ((job.op != Solve && job.op != Count) || !sizeOk ||
+            (job.op == Count && job.arg == 0) ||
+            len != HeaderSize + static_cast<uint32_t>(job.size) * job.size) {
+            job.status = SUDOKU_INVALID_ARGUMENT;
+            queueResponse(conn, job);
+            continue;
+        }
+
+        if (queueDepth() + pending.size() >= opts.maxQueued) {
+            job.status = Busy;
+            ++rejected;
+            queueResponse(conn, job);
+            continue;
+        }
+
+        std::memcpy(job.cells, body + HeaderSize, job.size * job.size);
+        ++inFlight;
+        ++conn.jobs;
+        pending.push_back(job);
+    }
+
+    conn.in.erase(conn.in.begin(), conn.in.begin() + static_cast<std::ptrdiff_t>(pos));
+    return true;
+}
+
+// everything parsed in one wakeup goes out in maxBatch-sized chunks, each
+// to the currently least loaded worker
+void SolveDaemon::dispatchPending() {
+    size_t i = 0;
+    while (i < pending.size()) {
+        const size_t n = std::min(opts.maxBatch, pending.size() - i);
+
+        Worker *target = workers.front().get();
+        for (auto &w : workers) {
+            if (w->depth < target->depth) target = w.get();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(target->mutex);
+            auto first = pending.begin() + static_cast<std::ptrdiff_t>(i);
+            target->inbox.insert(target->inbox.end(),
+                                 std::make_move_iterator(first),
+                                 std::make_move_iterator(first + static_cast<std::ptrdiff_t>(n)));
+            target->depth += n;
+        }
+        target->wake.notify_one();
+        i += n;
+    }
+    pending.clear();
+}
+
+void SolveDaemon::drainCompletions() {
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        doneSwap.swap(done);
+    }
+
+    const auto now = Clock::now();
+    std::vector<int> touched;
+    touched.reserve(doneSwap.size());
+    for (const Job &job : doneSwap) {
+        --inFlight;
+        ++completed;
+
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      now - job.received).count();
+        int bucket = 0;
+        while (bucket < HistogramBuckets - 1 && (1LL << bucket) <= us) ++bucket;
+        ++histogram[bucket];
+
+        auto it = conns.find(job.fd);
+        if (it == conns.end() || it->second.gen != job.connGen) continue;  // client left
+        --it->second.jobs;
+        queueResponse(it->second, job);
+        touched.push_back(job.fd);
+    }
+    doneSwap.clear();
+
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (int fd : touched) {
+        auto it = conns.find(fd);
+        if (it != conns.end()) advance(it->second);
+    }
+}
+
+// ---------------- responses ----------------
+
+void SolveDaemon::queueResponse(Connection &conn, const Job &job) {
+    size_t payload = 0;
+    if (job.status == SUDOKU_OK)
+        payload = (job.op == Solve) ? static_cast<size_t>(job.size) * job.size : 4;
+
+    uint8_t header[4 + HeaderSize];
+    writeU32(header, static_cast<uint32_t>(HeaderSize + payload));
+    writeU64(header + 4, job.id);
+    header[12] = job.op;
+    header[13] = job.size;
+    writeU16(header + 14, static_cast<uint16_t>(job.status));
+    conn.out.insert(conn.out.end(), header, header + sizeof(header));
+
+    if (payload == 0) return;
+    if (job.op == Solve) {
+        conn.out.insert(conn.out.end(), job.cells, job.cells + payload);
+    } else {
+        uint8_t count[4];
+        writeU32(count, job.count);
+        conn.out.insert(conn.out.end(), count, count + 4);
+    }
+}
+
+void SolveDaemon::queueStats(Connection &conn, uint64_t id) {
+    const std::string json = statsJson();
+
+    uint8_t header[4 + HeaderSize];
+    writeU32(header, static_cast<uint32_t>(HeaderSize + json.size()));
+    writeU64(header + 4, id);
+    header[12] = Stats;
+    header[13] = 0;
+    writeU16(header + 14, SUDOKU_OK);
+    conn.out.insert(conn.out.end(), header, header + sizeof(header));
+    conn.out.insert(conn.out.end(), json.begin(), json.end());
+}
+
+// false on a send error; whatever the socket would not take stays queued
+bool SolveDaemon::flush(Connection &conn) {
+    while (conn.outPos < conn.out.size()) {
+        ssize_t n = ::send(conn.fd, conn.out.data() + conn.outPos,
+                           conn.out.size() - conn.outPos, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.outPos += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        return false;
+    }
+
+    conn.out.clear();
+    conn.outPos = 0;
+    return true;
+}
+
+// readable while the client may send and its backlog has room, writable
+// while replies are queued
+void SolveDaemon::watch(Connection &conn) {
+    uint32_t events = 0;
+    if (!conn.eof && backlog(conn) < MaxBacklog) events |= EPOLLIN;
+    if (conn.outPos < conn.out.size()) events |= EPOLLOUT;
+    if (events == conn.events) return;
+
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = conn.fd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &ev);
+    conn.events = events;
+}
+
+void SolveDaemon::closeClient(int fd) {
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    conns.erase(fd);
+}
+
+// ---------------- workers ----------------
+
+void SolveDaemon::workerLoop(Worker &w) {
+    std::vector<Job> batch;
+    batch.reserve(opts.maxBatch * 4);
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(w.mutex);
+            w.wake.wait(lock, [&]() { return stopping || !w.inbox.empty(); });
+            if (w.inbox.empty()) return;   // stopping
+            batch.swap(w.inbox);
+        }
+
+        for (Job &job : batch) execute(w, job);
+        w.depth -= batch.size();
+
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            done.insert(done.end(), std::make_move_iterator(batch.begin()),
+                        std::make_move_iterator(batch.end()));
+        }
+        batch.clear();
+
+        uint64_t one = 1;
+        (void)!::write(wakeFd, &one, sizeof(one));
+    }
+}
+
+void SolveDaemon::execute(Worker &w, Job &job) {
+    const int size = job.size;
+    int grid[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    for (int i = 0; i < size * size; ++i) {
+        if (job.cells[i] > size) {
+            job.status = SUDOKU_INVALID_ARGUMENT;
+            return;
+        }
+        grid[i / size][i % size] = job.cells[i];
+    }
+
+    if (!w.engine.loadPuzzle(grid, size)) {
+        job.status = SUDOKU_INVALID_GRID;
+        return;
+    }
+
+    if (job.op == Count) {
+        job.count = static_cast<uint32_t>(w.engine.countSolutions(job.arg));
+        job.status = SUDOKU_OK;
+        return;
+    }
+
+    if (!w.engine.solve(size)) {
+        job.status = SUDOKU_NO_SOLUTION;
+        return;
+    }
+    w.engine.getGrid(grid);
+    for (int i = 0; i < size * size; ++i)
+        job.cells[i] = static_cast<uint8_t>(grid[i / size][i % size]);
+    job.status = SUDOKU_OK;
+}
+
+// ---------------- stats ----------------
+
+size_t SolveDaemon::queueDepth() const {
+    size_t total = 0;
+    for (const auto &w : workers) total += w->depth;
+    return total;
+}
+
+// upper bound (in microseconds) of the bucket holding the p-quantile
+uint64_t SolveDaemon::percentile(double p) const {
+    uint64_t total = 0;
+    for (const auto &b : histogram) total += b;
+    if (total == 0) return 0;
+
+    const double target = p * static_cast<double>(total);
+    uint64_t seen = 0;
+    for (int i = 0; i < HistogramBuckets; ++i) {
+        seen += histogram[i];
+        if (static_cast<double>(seen) >= target) return 1ULL << i;
+    }
+    return 1ULL << (HistogramBuckets - 1);
+}
+
+std::string SolveDaemon::statsJson() const {
+    std::string json;
+    char buf[256];
+
+    std::snprintf(buf, sizeof(buf),
+                  "{\"in_flight\":%llu,\"queue_depth\":%zu,\"completed\":%llu,"
+                  "\"rejected\":%llu,\"workers\":%d,",
+                  static_cast<unsigned long long>(inFlight.load()), queueDepth(),
+                  static_cast<unsigned long long>(completed.load()),
+                  static_cast<unsigned long long>(rejected.load()), opts.workers);
+    json += buf;
+
+    std::snprintf(buf, sizeof(buf),
+                  "\"latency_us\":{\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu},",
+                  static_cast<unsigned long long>(percentile(0.50)),
+                  static_cast<unsigned long long>(percentile(0.90)),
+                  static_cast<unsigned long long>(percentile(0.99)),
+                  static_cast<unsigned long long>(percentile(0.999)));
+    json += buf;
+
+    // bucket i counts latencies in [2^(i-1), 2^i) microseconds
+    json += "\"histogram\":[";
+    for (int i = 0; i < HistogramBuckets; ++i) {
+        if (i) json += ',';
+        json += std::to_string(histogram[i].load());
+    }
+    json += "]}";
+    return json;
+}
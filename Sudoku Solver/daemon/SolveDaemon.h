@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "SudokuEngine.h"
+
+// Serves solve requests from local processes over a Unix domain socket
+// (see SolveProtocol.h). One epoll thread does all socket I/O; requests
+// parsed in the same wakeup are handed to the worker threads as batches,
+// and each worker owns one preallocated SudokuEngine.
+//
+// A client that owes MaxBacklog bytes of replies, counting requests still
+// with the workers, is not read from until it has taken some of them. A
+// client that shuts down its sending side is answered in full, then closed.
+class SolveDaemon {
+public:
+    struct Options {
+        std::string socketPath;
+        int workers = 4;
+        size_t maxBatch = 64;       // requests per worker hand-off
+        size_t maxQueued = 65536;   // beyond this, answer Busy
+    };
+
+    explicit SolveDaemon(const Options &opts);
+    ~SolveDaemon();
+
+    SolveDaemon(const SolveDaemon &) = delete;
+    SolveDaemon &operator=(const SolveDaemon &) = delete;
+
+    // binds the socket and starts the workers
+    bool start(std::string &error);
+
+    // runs the event loop until SIGINT or SIGTERM; SIGUSR1 dumps stats
+    int run();
+
+    std::string statsJson() const;
+
+    static constexpr size_t MaxBacklog = 1 << 20;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // bytes read from one client per wakeup before its frames are parsed
+    static constexpr size_t ReadChunk = 256 * 1024;
+
+    struct Job {
+        uint64_t id = 0;
+        int fd = -1;
+        uint32_t connGen = 0;
+        uint8_t op = 0;
+        uint8_t size = 0;
+        uint16_t arg = 0;
+        int16_t status = 0;
+        uint32_t count = 0;
+        Clock::time_point received;
+        uint8_t cells[SudokuEngine::MaxSize * SudokuEngine::MaxSize]{};
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::vector<Job> inbox;
+        std::atomic<size_t> depth{0};
+        SudokuEngine engine;
+    };
+
+    struct Connection {
+        int fd = -1;
+        uint32_t gen = 0;
+        std::vector<uint8_t> in;
+        std::vector<uint8_t> out;
+        size_t outPos = 0;
+        size_t jobs = 0;          // parsed, not yet answered
+        uint32_t events = 0;      // registered with epoll
+        bool eof = false;         // client shut down its sending side
+    };
+
+    // log2 buckets of microseconds
+    static constexpr int HistogramBuckets = 32;
+
+    Options opts;
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;      // eventfd, workers -> event loop
+    int signalFd = -1;
+    uint32_t nextGen = 1;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> stopping{false};
+
+    std::unordered_map<int, Connection> conns;
+    std::vector<Job> pending;   // parsed this wakeup, not yet dispatched
+
+    std::mutex doneMutex;
+    std::vector<Job> done;
+    std::vector<Job> doneSwap;
+
+    std::atomic<uint64_t> inFlight{0};
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> rejected{0};
+    std::atomic<uint64_t> histogram[HistogramBuckets]{};
+
+    void workerLoop(Worker &w);
+    void execute(Worker &w, Job &job);
+
+    void acceptClients();
+    void readClient(Connection &conn);
+    void advance(Connection &conn);
+    bool parseFrames(Connection &conn);
+    void dispatchPending();
+    void drainCompletions();
+    void queueResponse(Connection &conn, const Job &job);
+    void queueStats(Connection &conn, uint64_t id);
+    bool flush(Connection &conn);
+    void watch(Connection &conn);
+    void closeClient(int fd);
+    static size_t backlog(const Connection &conn);
+
+    size_t queueDepth() const;
+    uint64_t percentile(double p) const;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Wire format spoken by sudokud. Every integer is little-endian.
+//
+//   frame    := u32 length | body[length]
+//   request  := u64 id | u8 op | u8 size | u16 arg | cells[size * size]
+//   response := u64 id | u8 op | u8 size | i16 status | payload
+//
+// Cells are one byte each, row-major, 0 for empty. Responses carry the
+// request id and may arrive in any order; the payload is only present
+// when status is 0.
+//   Solve: payload is the solved grid
+//   Count: arg is the solution limit, 1 or more (0 is an invalid
+//          argument), payload is a u32 count
+//   Stats: no cells in the request, payload is a JSON document
+// status uses the SUDOKU_* codes from sudoku.h plus Busy below.
+//
+// A client may shut down its sending side after the last request; every
+// request already sent is still answered before the daemon closes.
+namespace SolveProtocol {
+
+enum Op : uint8_t {
+    Solve = 1,
+    Count = 2,
+    Stats = 3,
+};
+
+constexpr int16_t Busy = -100;   // queue full, retry later
+
+constexpr size_t HeaderSize = 12;
+constexpr uint32_t MaxFrame = 64 * 1024;
+
+inline uint16_t readU16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t readU32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t readU64(const uint8_t *p) {
+    return static_cast<uint64_t>(readU32(p)) |
+           (static_cast<uint64_t>(readU32(p + 4)) << 32);
+}
+
+inline void writeU16(uint8_t *p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+inline void writeU32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+inline void writeU64(uint8_t *p, uint64_t v) {
+    writeU32(p, static_cast<uint32_t>(v));
+    writeU32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+} // namespace SolveProtocol
@@ -0,0 +1,66 @@
+// sudokud: local solve daemon, see SolveProtocol.h for the wire format.
+// Usage: sudokud [--socket PATH] [--workers N] [--batch N] [--max-queued N]
+
+#include "SolveDaemon.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::string defaultSocketPath() {
+    const char *runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+    return std::string(runtimeDir ? runtimeDir : "/tmp") + "/sudokud.sock";
+}
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: sudokud [--socket PATH] [--workers N] [--batch N] "
+                 "[--max-queued N]\n");
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    SolveDaemon::Options opts;
+    opts.socketPath = defaultSocketPath();
+    opts.workers = static_cast<int>(std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            usage();
+            return 2;
+        }
+
+        if (std::strcmp(arg, "--socket") == 0) {
+            opts.socketPath = value;
+        } else if (std::strcmp(arg, "--workers") == 0) {
+            opts.workers = std::atoi(value);
+        } else if (std::strcmp(arg, "--batch") == 0) {
+            opts.maxBatch = static_cast<size_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--max-queued") == 0) {
+            opts.maxQueued = static_cast<size_t>(std::atoll(value));
+        } else {
+            usage();
+            return 2;
+        }
+        ++i;
+    }
+
+    SolveDaemon daemon(opts);
+    std::string error;
+    if (!daemon.start(error)) {
+        std::fprintf(stderr, "sudokud: %s\n", error.c_str());
+        return 1;
+    }
+
+    std::fprintf(stderr, "sudokud: listening on %s\n", opts.socketPath.c_str());
+    int rc = daemon.run();
+    std::fprintf(stderr, "%s\n", daemon.statsJson().c_str());
+    return rc;
+}
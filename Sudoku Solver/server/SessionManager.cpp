@@ -0,0 +1,244 @@
+#include "SessionManager.h"
+
+#include <cstring>
+
+// ---------------- constructor ----------------
+
+SessionManager::SessionManager()
+    : epoch(Clock::now()) {
+}
+
+// ---------------- packed cells ----------------
+
+int SessionManager::cellAt(const PackedGame &g, int cell) {
+    return (g.cells[cell >> 1] >> ((cell & 1) * 4)) & 0xf;
+}
+
+void SessionManager::setCell(PackedGame &g, int cell, int val) {
+    const int shift = (cell & 1) * 4;
+    uint8_t &byte = g.cells[cell >> 1];
+    byte = static_cast<uint8_t>((byte & ~(0xf << shift)) | (val << shift));
+}
+
+bool SessionManager::isGiven(const PackedGame &g, int cell) {
+    return (g.given[cell >> 3] >> (cell & 7)) & 1;
+}
+
+// digits used by the row, column and box peers of cell (bit v = digit v);
+// the cell's own value is left out so it can be overwritten
+uint16_t SessionManager::peerMask(const PackedGame &g, int cell) {
+    const int size = g.size;
+    const int boxRows = (size == 6) ? 2 : 3;
+    const int boxCols = size / boxRows;
+    const int r = cell / size;
+    const int c = cell % size;
+
+    uint16_t mask = 0;
+    for (int i = 0; i < size; ++i) {
+        if (i != c) mask |= static_cast<uint16_t>(1u << cellAt(g, r * size + i));
+        if (i != r) mask |= static_cast<uint16_t>(1u << cellAt(g, i * size + c));
+    }
+    const int br = r - r % boxRows;
+    const int bc = c - c % boxCols;
+    for (int i = br; i < br + boxRows; ++i) {
+        if (i == r) continue;
+        for (int j = bc; j < bc + boxCols; ++j) {
+            if (j != c) mask |= static_cast<uint16_t>(1u << cellAt(g, i * size + j));
+        }
+    }
+    return static_cast<uint16_t>(mask & ~1u);   // bit 0 is "empty"
+}
+
+int SessionManager::strikesAt(const PackedGame &g, int slot) {
+    return (g.strikeCounts >> (slot * StrikeBits)) & ((1u << StrikeBits) - 1);
+}
+
+void SessionManager::setStrikes(PackedGame &g, int slot, int count) {
+    const int shift = slot * StrikeBits;
+    g.strikeCounts = (g.strikeCounts & ~(((1u << StrikeBits) - 1) << shift)) |
+                     (static_cast<uint32_t>(count) << shift);
+}
+
+// returns the cell's strike count after adding one
+int SessionManager::strike(PackedGame &g, int cell) {
+    int slot = -1;
+    for (int i = 0; i < StrikeSlots; ++i) {
+        if (g.strikeCell[i] == cell) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) {
+        // empty slot, or else forgive the cell with the fewest strikes
+        slot = 0;
+        for (int i = 0; i < StrikeSlots; ++i) {
+            if (g.strikeCell[i] == NoCell) {
+                slot = i;
+                break;
+            }
+            if (strikesAt(g, i) < strikesAt(g, slot)) slot = i;
+        }
+        g.strikeCell[slot] = static_cast<uint8_t>(cell);
+        setStrikes(g, slot, 0);
+    }
+    const int count = strikesAt(g, slot) + 1;
+    setStrikes(g, slot, count);
+    return count;
+}
+
+// ---------------- sessions ----------------
+
+uint32_t SessionManager::now() const {
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - epoch).count());
+}
+
+SessionManager::PackedGame *SessionManager::find(SessionId id) {
+    const uint32_t index = static_cast<uint32_t>(id);
+    const uint32_t gen = static_cast<uint32_t>(id >> 32);
+    if (index >= generation.size() || generation[index] != gen) return nullptr;
+    PackedGame &g = pool[index];
+    return g.state == Free ? nullptr : &g;
+}
+
+const SessionManager::PackedGame *SessionManager::find(SessionId id) const {
+    return const_cast<SessionManager *>(this)->find(id);
+}
+
+SessionManager::SessionId SessionManager::adopt(const PackedGame &game) {
+    const uint32_t index = pool.allocate();
+    if (generation.size() < pool.capacity())
+        generation.resize(pool.capacity(), 1);
+    pool[index] = game;
+    return (static_cast<SessionId>(generation[index]) << 32) | index;
+}
+
+SessionManager::SessionId SessionManager::create(const uint8_t *cells, int size) {
+    if (!cells || (size != 6 && size != 9 && size != 12)) return InvalidSession;
+
+    PackedGame g{};
+    g.size = static_cast<uint8_t>(size);
+    g.state = Playing;
+    g.clock = now();
+    std::memset(g.strikeCell, NoCell, sizeof(g.strikeCell));
+
+    for (int cell = 0; cell < size * size; ++cell) {
+        const int val = cells[cell];
+        if (val > size) return InvalidSession;
+        if (val == 0) continue;
+        setCell(g, cell, val);
+        g.given[cell >> 3] |= static_cast<uint8_t>(1u << (cell & 7));
+        ++g.filled;
+    }
+    for (int cell = 0; cell < size * size; ++cell) {
+        const int val = cellAt(g, cell);
+        if (val != 0 && (peerMask(g, cell) & (1u << val))) return InvalidSession;
+    }
+    if (g.filled == size * size) {
+        g.state = Solved;
+        g.clock = 0;   // solved before any play
+    }
+    return adopt(g);
+}
+
+SessionManager::SessionId SessionManager::create(int size, uint32_t seed, int targetGivens) {
+    if (size != 6 && size != 9 && size != 12) return InvalidSession;
+
+    engine.generate(size, seed, targetGivens);
+    int grid[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    engine.getGrid(grid);
+
+    uint8_t cells[SudokuEngine::MaxSize * SudokuEngine::MaxSize];
+    for (int r = 0; r < size; ++r)
+        for (int c = 0; c < size; ++c)
+            cells[r * size + c] = static_cast<uint8_t>(grid[r][c]);
+    return create(cells, size);
+}
+
+bool SessionManager::close(SessionId id) {
+    PackedGame *g = find(id);
+    if (!g) return false;
+
+    const uint32_t index = static_cast<uint32_t>(id);
+    g->state = Free;
+    if (++generation[index] == 0) generation[index] = 1;   // 0 is never issued
+    pool.release(index);
+    return true;
+}
+
+bool SessionManager::board(SessionId id, uint8_t *out) const {
+    const PackedGame *g = find(id);
+    if (!g || !out) return false;
+    for (int cell = 0; cell < g->size * g->size; ++cell)
+        out[cell] = static_cast<uint8_t>(cellAt(*g, cell));
+    return true;
+}
+
+int SessionManager::elapsedSeconds(SessionId id) const {
+    const PackedGame *g = find(id);
+    if (!g) return -1;
+    return static_cast<int>(g->state == Playing ? now() - g->clock : g->clock);
+}
+
+// ---------------- requests ----------------
+
+SessionManager::Reply SessionManager::handle(const Request &req) {
+    Reply reply;
+    if (req.op == Op::Close) {
+        reply.status = close(req.session) ? Status::Ok : Status::NoSession;
+        return reply;
+    }
+
+    PackedGame *g = find(req.session);
+    if (!g) return reply;   // NoSession
+
+    if (g->state != Playing) {
+        reply.status = Status::Finished;
+        return reply;
+    }
+    const int cell = req.cell;
+    const int val = req.value;
+    if (cell >= g->size * g->size || val > g->size) {
+        reply.status = Status::BadRequest;
+        return reply;
+    }
+    if (isGiven(*g, cell)) {
+        reply.status = Status::Given;
+        return reply;
+    }
+
+    const int oldVal = cellAt(*g, cell);
+
+    if (val != 0 && (peerMask(*g, cell) & (1u << val))) {
+        // like the desktop game, a wrong digit also clears the cell
+        if (oldVal != 0) {
+            setCell(*g, cell, 0);
+            --g->filled;
+        }
+        reply.strikes = static_cast<uint8_t>(strike(*g, cell));
+        if (reply.strikes >= MaxStrikes) {
+            g->state = Over;
+            g->clock = now() - g->clock;
+            reply.status = Status::GameOver;
+        } else {
+            reply.status = Status::Wrong;
+        }
+        return reply;
+    }
+
+    setCell(*g, cell, val);
+    g->filled = static_cast<uint8_t>(g->filled + (val != 0) - (oldVal != 0));
+    if (g->filled == g->size * g->size) {
+        g->state = Solved;
+        g->clock = now() - g->clock;
+        reply.status = Status::Completed;
+    } else {
+        reply.status = Status::Ok;
+    }
+    return reply;
+}
+
+void SessionManager::handle(const Request *reqs, Reply *replies, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        replies[i] = handle(reqs[i]);
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SlabPool.h"
+#include "SudokuEngine.h"
+
+// Headless host for many concurrent games. Each game lives in a packed
+// record of 108 bytes inside a slab pool; row/column/box masks are
+// rebuilt from the packed cells only for the peers of the cell being
+// played. Moves follow the desktop game's rules: a clashing digit is a
+// strike against that cell and MaxStrikes strikes end the game.
+//
+// Not thread-safe; run one manager per thread and shard sessions by id.
+class SessionManager {
+public:
+    // (generation << 32) | slot; stale ids are rejected once a slot is reused
+    using SessionId = uint64_t;
+    static constexpr SessionId InvalidSession = 0;
+
+    static constexpr int MaxStrikes = 5;
+
+    enum class Op : uint8_t {
+        Place,   // value 0 clears the cell
+        Close,
+    };
+
+    enum class Status : int8_t {
+        Ok,
+        Wrong,        // digit clashes with a peer; a strike was recorded
+        GameOver,     // this move used up the cell's strikes
+        Completed,    // this move filled the board
+        Finished,     // game already over or completed, move ignored
+        Given,        // cell holds a given
+        BadRequest,   // cell or value out of range
+        NoSession,
+    };
+
+    struct Request {
+        SessionId session = InvalidSession;
+        Op op = Op::Place;
+        uint8_t cell = 0;     // row * size + col
+        uint8_t value = 0;
+    };
+
+    struct Reply {
+        Status status = Status::NoSession;
+        uint8_t strikes = 0;  // against the cell, for Wrong and GameOver
+    };
+
+    SessionManager();
+
+    // cells: size * size bytes, row-major, 0 for empty. Returns
+    // InvalidSession for a bad size, out-of-range values or clashing givens.
+    SessionId create(const uint8_t *cells, int size);
+
+    // new puzzle from SudokuEngine::generate
+    SessionId create(int size, uint32_t seed, int targetGivens);
+
+    bool close(SessionId id);
+
+    Reply handle(const Request &req);
+    void handle(const Request *reqs, Reply *replies, size_t count);
+
+    // current board, size * size bytes; false for an unknown session
+    bool board(SessionId id, uint8_t *out) const;
+    int elapsedSeconds(SessionId id) const;
+
+    uint32_t sessions() const { return pool.live(); }
+    size_t bytesReserved() const {
+        return pool.bytesReserved() + generation.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    enum State : uint8_t { Free, Playing, Over, Solved };
+
+    // strikes are kept for the last few cells that earned one; when the
+    // table is full the cell with the fewest strikes is forgiven
+    static constexpr int StrikeSlots = 8;
+    static constexpr int StrikeBits = 3;
+    static constexpr uint8_t NoCell = 0xff;
+    static_assert(MaxStrikes < (1 << StrikeBits), "strike count must fit its bits");
+
+    // a 12x12 board and its givens take 90 bytes; the rest is the clock,
+    // the strike table and three bytes of state
+    struct PackedGame {
+        uint32_t clock;                  // start second while playing, elapsed after
+        uint32_t strikeCounts;           // StrikeBits per slot, slot 0 lowest
+        uint8_t  cells[72];              // two cells per byte, low nibble first
+        uint8_t  given[18];              // one bit per cell
+        uint8_t  strikeCell[StrikeSlots];
+        uint8_t  size : 4;
+        uint8_t  state : 4;
+        uint8_t  filled;
+    };
+    static_assert(sizeof(PackedGame) <= 108, "keep sessions compact");
+
+    using Clock = std::chrono::steady_clock;
+
+    SlabPool<PackedGame> pool;
+    std::vector<uint32_t> generation;   // per slot
+    Clock::time_point epoch;
+    SudokuEngine engine;                // only for create(size, seed, ...)
+
+    PackedGame *find(SessionId id);
+    const PackedGame *find(SessionId id) const;
+    SessionId adopt(const PackedGame &game);
+    uint32_t now() const;
+
+    static int cellAt(const PackedGame &g, int cell);
+    static void setCell(PackedGame &g, int cell, int val);
+    static bool isGiven(const PackedGame &g, int cell);
+    static uint16_t peerMask(const PackedGame &g, int cell);
+    static int strikesAt(const PackedGame &g, int slot);
+    static void setStrikes(PackedGame &g, int slot, int count);
+    static int strike(PackedGame &g, int cell);
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Fixed-size slots carved out of SlabSlots-sized blocks. Slots are
+// addressed by a dense 32-bit index, never move once allocated, and freed
+// slots are reused before a new slab is added, so a pool of small records
+// costs one allocation per slab rather than one per record.
+template <typename T, uint32_t SlabSlots = 4096>
+class SlabPool {
+public:
+    // returns the index of a value-initialised slot
+    uint32_t allocate() {
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            if (nextFresh == capacity())
+                slabs.emplace_back(new T[SlabSlots]);
+            index = nextFresh++;
+        }
+        (*this)[index] = T{};
+        ++liveCount;
+        return index;
+    }
+
+    void release(uint32_t index) {
+        freeSlots.push_back(index);
+        --liveCount;
+    }
+
+    T &operator[](uint32_t index) {
+        return slabs[index / SlabSlots][index % SlabSlots];
+    }
+    const T &operator[](uint32_t index) const {
+        return slabs[index / SlabSlots][index % SlabSlots];
+    }
+
+    uint32_t live() const { return liveCount; }
+    uint32_t capacity() const {
+        return static_cast<uint32_t>(slabs.size()) * SlabSlots;
+    }
+
+    // slab memory plus the free list
+    size_t bytesReserved() const {
+        return slabs.size() * SlabSlots * sizeof(T) +
+               freeSlots.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    std::vector<std::unique_ptr<T[]>> slabs;
+    std::vector<uint32_t> freeSlots;
+    uint32_t nextFresh = 0;
+    uint32_t liveCount = 0;
+};
@@ -0,0 +1,104 @@
+#include "AutosaveWriter.h"
+
+#include <cstdio>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::FILE *openForWrite(const std::filesystem::path &file) {
+#ifdef _WIN32
+    return _wfopen(file.c_str(), L"wb");
+#else
+    return std::fopen(file.c_str(), "wb");
+#endif
+}
+
+// pushes what the OS holds for f out to the disk
+bool syncFile(std::FILE *f) {
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+// makes a rename into dir survive a crash; Windows has no equivalent
+void syncDirectory(const std::filesystem::path &dir) {
+#ifndef _WIN32
+    const int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+#else
+    (void)dir;
+#endif
+}
+
+} // namespace
+
+AutosaveWriter::AutosaveWriter(std::filesystem::path target)
+    : path(std::move(target)),
+      thread([this]() { run(); }) {
+}
+
+AutosaveWriter::~AutosaveWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void AutosaveWriter::submit(std::vector<uint8_t> bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = std::move(bytes);
+        hasPending = true;
+    }
+    wake.notify_one();
+}
+
+void AutosaveWriter::run() {
+    std::vector<uint8_t> current;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || hasPending; });
+            if (!hasPending) return;   // stopping, nothing left to write
+            current.swap(pending);
+            hasPending = false;
+        }
+        writeFile(current);
+    }
+}
+
+bool AutosaveWriter::writeFile(const std::vector<uint8_t> &bytes) const {
+    std::filesystem::path tmp = path;
+    tmp += ".tmp";
+
+    // the last good autosave is only replaced once the new one is on disk
+    std::FILE *out = openForWrite(tmp);
+    if (!out) return false;
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size();
+    ok = std::fflush(out) == 0 && ok;
+    ok = ok && syncFile(out);
+    ok = std::fclose(out) == 0 && ok;
+
+    std::error_code ec;
+    if (!ok) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) return false;
+    syncDirectory(path.parent_path());
+    return true;
+}
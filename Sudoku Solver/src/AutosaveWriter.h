@@ -0,0 +1,37 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Writes snapshots on a background thread so the GUI never waits on disk.
+// Only the newest submitted buffer matters: anything not yet written is
+// replaced. Each write goes to "<path>.tmp", is synced to disk and only
+// then renamed over the target, so a crash or a full disk leaves the last
+// good autosave in place.
+class AutosaveWriter {
+public:
+    explicit AutosaveWriter(std::filesystem::path target);
+    ~AutosaveWriter();   // finishes the pending write, if any
+
+    AutosaveWriter(const AutosaveWriter &) = delete;
+    AutosaveWriter &operator=(const AutosaveWriter &) = delete;
+
+    void submit(std::vector<uint8_t> bytes);
+
+private:
+    std::filesystem::path path;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<uint8_t> pending;
+    bool hasPending = false;
+    bool stopping = false;
+
+    std::thread thread;
+
+    void run();
+    bool writeFile(const std::vector<uint8_t> &bytes) const;
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+
+// Every set of distinct digits from 1..12, bucketed at compile time by
+// (digit count, digit sum). Masks follow SudokuEngine's convention: bit v
+// stands for digit v. Smaller value ranges just skip the sets that use
+// digits above the grid size.
+namespace CageTables {
+
+constexpr int MaxDigits = 12;
+constexpr int MaxSum = MaxDigits * (MaxDigits + 1) / 2;   // 78
+constexpr int Keys = (MaxDigits + 1) * (MaxSum + 1);
+
+struct ComboIndex {
+    uint16_t offset[Keys + 1];            // bucket k*(MaxSum+1)+s
+    uint16_t masks[1 << MaxDigits];
+};
+
+constexpr int key(int count, int sum) {
+    return count * (MaxSum + 1) + sum;
+}
+
+constexpr ComboIndex buildIndex() {
+    ComboIndex idx{};
+    int counts[Keys]{};
+    int keyOf[1 << MaxDigits]{};
+
+    for (int set = 0; set < (1 << MaxDigits); ++set) {
+        int count = 0, sum = 0;
+        for (int d = 0; d < MaxDigits; ++d) {
+            if (set & (1 << d)) {
+                ++count;
+                sum += d + 1;
+            }
+        }
+        keyOf[set] = key(count, sum);
+        ++counts[keyOf[set]];
+    }
+
+    for (int k = 0; k < Keys; ++k)
+        idx.offset[k + 1] = static_cast<uint16_t>(idx.offset[k] + counts[k]);
+
+    int fill[Keys]{};
+    for (int set = 0; set < (1 << MaxDigits); ++set) {
+        int k = keyOf[set];
+        idx.masks[idx.offset[k] + fill[k]++] = static_cast<uint16_t>(set << 1);
+    }
+    return idx;
+}
+
+inline constexpr ComboIndex Index = buildIndex();
+
+struct ComboRange {
+    const uint16_t *first;
+    const uint16_t *last;
+    const uint16_t *begin() const { return first; }
+    const uint16_t *end() const { return last; }
+};
+
+// digit sets of exactly count digits adding up to sum
+inline ComboRange combos(int count, int sum) {
+    if (count < 0 || count > MaxDigits || sum < 0 || sum > MaxSum)
+        return {Index.masks, Index.masks};
+    const int k = key(count, sum);
+    return {Index.masks + Index.offset[k], Index.masks + Index.offset[k + 1]};
+}
+
+} // namespace CageTables
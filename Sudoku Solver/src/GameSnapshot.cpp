@@ -0,0 +1,115 @@
+#include "GameSnapshot.h"
+
+#include <cstring>
+
+namespace {
+
+constexpr int Cells = SudokuEngine::MaxSize * SudokuEngine::MaxSize;
+
+// native byte order; byteOrder catches files moved between hosts
+struct Header {
+    char     magic[4];
+    uint16_t version;
+    uint16_t byteOrder;
+    uint8_t  size;
+    uint8_t  gameOver;
+    uint16_t reserved;
+    uint32_t elapsedSeconds;
+    uint32_t historyCount;
+    uint32_t historyPosition;
+    uint32_t replayCount;
+    uint8_t  board[Cells];
+    uint8_t  givens[(Cells + 7) / 8];
+    uint8_t  wrongAttempts[Cells];
+};
+
+constexpr char Magic[4] = {'S', 'D', 'K', 'S'};
+constexpr uint16_t ByteOrderMark = 0x0102;
+
+static_assert(sizeof(Move) == 6, "Move is written to disk as-is");
+
+// the cell must be on the board, both values in range and the mask the
+// one Move::make would have built, or replaying it writes out of bounds
+bool validMoves(const Move *moves, size_t count, int size) {
+    for (size_t i = 0; i < count; ++i) {
+        const Move &m = moves[i];
+        if (m.cell / SudokuEngine::MaxSize >= size || m.cell % SudokuEngine::MaxSize >= size)
+            return false;
+        if (m.oldValue > size || m.newValue > size) return false;
+        if (m.maskDelta != Move::make(m.cell, m.oldValue, m.newValue).maskDelta) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::vector<uint8_t> GameSnapshot::encode() const {
+    Header h{};
+    std::memcpy(h.magic, Magic, sizeof(Magic));
+    h.version = Version;
+    h.byteOrder = ByteOrderMark;
+    h.size = static_cast<uint8_t>(size);
+    h.gameOver = gameOver ? 1 : 0;
+    h.elapsedSeconds = elapsedSeconds;
+    h.historyCount = static_cast<uint32_t>(history.size());
+    h.historyPosition = static_cast<uint32_t>(historyPosition);
+    h.replayCount = static_cast<uint32_t>(replay.size());
+
+    for (int i = 0; i < Cells; ++i) {
+        const int r = i / SudokuEngine::MaxSize;
+        const int c = i % SudokuEngine::MaxSize;
+        h.board[i] = board[r][c];
+        h.wrongAttempts[i] = wrongAttempts[r][c];
+        if (given[r][c]) h.givens[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+    }
+
+    const size_t historyBytes = history.size() * sizeof(Move);
+    const size_t replayBytes = replay.size() * sizeof(Move);
+    std::vector<uint8_t> out(sizeof(Header) + historyBytes + replayBytes);
+    std::memcpy(out.data(), &h, sizeof(Header));
+    if (historyBytes)
+        std::memcpy(out.data() + sizeof(Header), history.data(), historyBytes);
+    if (replayBytes)
+        std::memcpy(out.data() + sizeof(Header) + historyBytes, replay.data(), replayBytes);
+    return out;
+}
+
+bool GameSnapshot::decode(const uint8_t *data, size_t len) {
+    if (!data || len < sizeof(Header)) return false;
+
+    Header h;
+    std::memcpy(&h, data, sizeof(Header));
+    if (std::memcmp(h.magic, Magic, sizeof(Magic)) != 0 ||
+        h.version != Version || h.byteOrder != ByteOrderMark)
+        return false;
+    if (h.size != 6 && h.size != 9 && h.size != 12) return false;
+    if (h.historyPosition > h.historyCount) return false;
+
+    const size_t historyBytes = static_cast<size_t>(h.historyCount) * sizeof(Move);
+    const size_t replayBytes = static_cast<size_t>(h.replayCount) * sizeof(Move);
+    if (len != sizeof(Header) + historyBytes + replayBytes) return false;
+
+    const auto *moves = data + sizeof(Header);
+    history.resize(h.historyCount);
+    if (historyBytes) std::memcpy(history.data(), moves, historyBytes);
+    replay.resize(h.replayCount);
+    if (replayBytes) std::memcpy(replay.data(), moves + historyBytes, replayBytes);
+    if (!validMoves(history.data(), history.size(), h.size) ||
+        !validMoves(replay.data(), replay.size(), h.size))
+        return false;
+
+    for (int i = 0; i < Cells; ++i) {
+        if (h.board[i] > h.size) return false;
+        const int r = i / SudokuEngine::MaxSize;
+        const int c = i % SudokuEngine::MaxSize;
+        board[r][c] = h.board[i];
+        wrongAttempts[r][c] = h.wrongAttempts[i];
+        given[r][c] = (h.givens[i / 8] >> (i % 8)) & 1u;
+    }
+
+    size = h.size;
+    gameOver = h.gameOver != 0;
+    elapsedSeconds = h.elapsedSeconds;
+    historyPosition = h.historyPosition;
+    return true;
+}
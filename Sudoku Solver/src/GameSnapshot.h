@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MoveJournal.h"
+#include "SudokuEngine.h"
+
+// Everything needed to resume a game. The on-disk form is one fixed-size
+// header (board, givens bitmask, per-cell wrong attempts, timer) followed
+// by the raw Move arrays, so loading is a bounds check plus memcpy.
+struct GameSnapshot {
+    static constexpr uint16_t Version = 1;
+
+    int size = 9;
+    uint32_t elapsedSeconds = 0;
+    bool gameOver = false;
+    uint8_t board[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    bool given[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    uint8_t wrongAttempts[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+
+    std::vector<Move> history;
+    size_t historyPosition = 0;
+    std::vector<Move> replay;
+
+    std::vector<uint8_t> encode() const;
+
+    // false if the data is truncated, from another version or corrupt,
+    // including any move that does not fit the board
+    bool decode(const uint8_t *data, size_t len);
+};
@@ -7,6 +7,11 @@
 #include <QRandomGenerator>
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <QKeySequence>
+#include <QSignalBlocker>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
 
 // ---------------- Constructor ----------------
 
@@ -21,21 +26,57 @@ MainWindow::MainWindow(QWidget *parent)
       newGameButton(new QPushButton("New Game", this)),
       solveButton(new QPushButton("Solve", this)),
       changeLevelButton(new QPushButton("Change Level", this)),
+      undoButton(new QPushButton("Undo", this)),
+      redoButton(new QPushButton("Redo", this)),
       statusLabel(new QLabel(this)),
       timerLabel(new QLabel(this)),
-      gameTimer(new QTimer(this)) {
+      gameTimer(new QTimer(this)),
+      autosaveTimer(new QTimer(this)) {
 
     setupUi();
 
-    stack->setCurrentWidget(homePage);
+    const QString dataDir =
+        QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    QDir().mkpath(dataDir);
+    autosavePath = dataDir + "/autosave.sdks";
+    autosave = std::make_unique<AutosaveWriter>(
+        std::filesystem::path(autosavePath.toStdU16String()));
+
+    connect(autosaveTimer, &QTimer::timeout, this, &MainWindow::saveIfDirty);
+    autosaveTimer->start(AutosaveIntervalMs);
+
+    // the placeholder puzzle built by setupUi is not worth saving
+    dirty = false;
+    if (restoreSnapshot()) {
+        stack->setCurrentWidget(gamePage);
+        gameTimer->start(1000);
+    } else {
+        stack->setCurrentWidget(homePage);
+    }
     setCentralWidget(stack);
     resize(900, 800);
     setWindowTitle("Sudoku Solver");
 }
 
+MainWindow::~MainWindow() {
+    saveIfDirty();
+    // autosave's destructor finishes the last write
+}
+
 // ================= UI setup =================
 
 void MainWindow::setupUi() {
+    // stable names for tools that drive the window (bench/GuiLatencyBench)
+    startButton->setObjectName("startButton");
+    difficultyBox->setObjectName("difficultyBox");
+    table->setObjectName("board");
+    newGameButton->setObjectName("newGameButton");
+    solveButton->setObjectName("solveButton");
+    changeLevelButton->setObjectName("changeLevelButton");
+    undoButton->setObjectName("undoButton");
+    redoButton->setObjectName("redoButton");
+    statusLabel->setObjectName("statusLabel");
+
     setupHomePage();
     setupGamePage();
 
@@ -48,6 +89,10 @@ void MainWindow::setupUi() {
             this, &MainWindow::onNewGame);
     connect(solveButton, &QPushButton::clicked,
             this, &MainWindow::onSolve);
+    connect(undoButton, &QPushButton::clicked,
+            this, &MainWindow::onUndo);
+    connect(redoButton, &QPushButton::clicked,
+            this, &MainWindow::onRedo);
     connect(changeLevelButton, &QPushButton::clicked,
             this, [this]() {
                 QDialog dlg(this);
@@ -88,12 +133,8 @@ void MainWindow::setupUi() {
 
     connect(gameTimer, &QTimer::timeout, this, [this]() {
         ++elapsedSeconds;
-        int m = elapsedSeconds / 60;
-        int s = elapsedSeconds % 60;
-        timerLabel->setText(
-            QString("Time: %1:%2")
-                .arg(m, 2, 10, QLatin1Char('0'))
-                .arg(s, 2, 10, QLatin1Char('0')));
+        dirty = true;
+        showElapsed();
     });
 }
 
@@ -212,11 +253,18 @@ void MainWindow::setupGamePage() {
     newGameButton->setStyleSheet(buttonStyle);
     solveButton->setStyleSheet(buttonStyle);
     changeLevelButton->setStyleSheet(buttonStyle);
+    undoButton->setStyleSheet(buttonStyle);
+    redoButton->setStyleSheet(buttonStyle);
+
+    undoButton->setShortcut(QKeySequence::Undo);
+    redoButton->setShortcut(QKeySequence::Redo);
 
     btnLayout->addStretch();
     btnLayout->addWidget(newGameButton);
     btnLayout->addWidget(solveButton);
     btnLayout->addWidget(changeLevelButton);
+    btnLayout->addWidget(undoButton);
+    btnLayout->addWidget(redoButton);
     btnLayout->addStretch();
 
     timerLabel->setText("Time: 00:00");
@@ -336,8 +384,9 @@ void MainWindow::loadRandomPuzzle(const QString &diff) {
             wrongAttempts[r][c] = 0;
 }
 
-void MainWindow::loadPuzzleForCurrentDifficulty() {
-    QString diff = difficultyBox->currentText();
+// board size and empty, editable items for the selected difficulty
+void MainWindow::setupBoardForCurrentDifficulty() {
+    const QString diff = difficultyBox->currentText();
 
     if (diff == "Easy") {
         currentSize = 6;
@@ -367,10 +416,20 @@ void MainWindow::loadPuzzleForCurrentDifficulty() {
             table->setItem(r, c, item);
         }
     }
+}
+
+void MainWindow::loadPuzzleForCurrentDifficulty() {
+    const QString diff = difficultyBox->currentText();
+    setupBoardForCurrentDifficulty();
 
     loadRandomPuzzle(diff);
     syncFromEngineToUi();
 
+    journal.clear();
+    gameOver = false;
+    dirty = true;
+    updateUndoButtons();
+
     statusLabel->setText("New game (" + diff + ")");
 }
 
@@ -379,6 +438,8 @@ void MainWindow::syncFromEngineToUi() {
     int grid[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
     engine.getGrid(grid);
 
+    QSignalBlocker blocker(table);
+
     for (int r = 0; r < currentSize; ++r) {
         for (int c = 0; c < currentSize; ++c) {
             auto *item = table->item(r, c);
@@ -399,31 +460,20 @@ void MainWindow::syncFromEngineToUi() {
                 item->setForeground(QColor("#22c55e"));
                 item->setBackground(QColor("#0f172a"));
             }
+            board[r][c] = static_cast<uint8_t>(grid[r][c]);
+            given[r][c] = grid[r][c] != 0;
         }
     }
+    rebuildMasks();
 }
 
 // map UI → engine grid
 void MainWindow::syncFromUiToEngine() {
     int grid[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
 
-    for (int r = 0; r < currentSize; ++r) {
-        for (int c = 0; c < currentSize; ++c) {
-            QTableWidgetItem *item = table->item(r, c);
-            int val = 0;
-            if (item) {
-                const QString txt = item->text().trimmed();
-                if (!txt.isEmpty()) {
-                    bool ok = false;
-                    int v = txt.toInt(&ok);
-                    if (ok && v >= 1 && v <= currentSize) {
-                        val = v;
-                    }
-                }
-            }
-            grid[r][c] = val;
-        }
-    }
+    for (int r = 0; r < currentSize; ++r)
+        for (int c = 0; c < currentSize; ++c)
+            grid[r][c] = board[r][c];
 
     engine.loadPuzzle(grid, currentSize);
 }
@@ -431,49 +481,169 @@ void MainWindow::syncFromUiToEngine() {
 // ================= helpers =================
 
 bool MainWindow::isUserMoveValid(int row, int col, int val) const {
-    int grid[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    // the cell's own current value does not count against it
+    const uint16_t own = static_cast<uint16_t>((1u << board[row][col]) & ~1u);
+    const uint16_t used = (rowMask[row] | colMask[col] | boxMask[boxOf(row, col)]) & ~own;
+    return (used & (1u << val)) == 0;
+}
+
+int MainWindow::boxOf(int row, int col) const {
+    return (row / boxRows) * (currentSize / boxCols) + col / boxCols;
+}
+
+void MainWindow::rebuildMasks() {
+    for (int i = 0; i < SudokuEngine::MaxSize; ++i)
+        rowMask[i] = colMask[i] = boxMask[i] = 0;
 
     for (int r = 0; r < currentSize; ++r) {
         for (int c = 0; c < currentSize; ++c) {
-            QTableWidgetItem *item = table->item(r, c);
-            int v = 0;
-            if (item) {
-                bool ok = false;
-                int t = item->text().toInt(&ok);
-                if (ok && t >= 1 && t <= currentSize) {
-                    v = t;
-                }
-            }
-            grid[r][c] = v;
+            if (board[r][c] == 0) continue;
+            const uint16_t bit = static_cast<uint16_t>(1u << board[r][c]);
+            rowMask[r] |= bit;
+            colMask[c] |= bit;
+            boxMask[boxOf(r, c)] |= bit;
         }
     }
+}
+
+void MainWindow::applyToBoard(const Move &m) {
+    const int r = m.cell / SudokuEngine::MaxSize;
+    const int c = m.cell % SudokuEngine::MaxSize;
+    board[r][c] = m.newValue;
+    rowMask[r] ^= m.maskDelta;
+    colMask[c] ^= m.maskDelta;
+    boxMask[boxOf(r, c)] ^= m.maskDelta;
+}
 
-    grid[row][col] = val;
+// the table already shows val; bring board, masks and history in line
+void MainWindow::commitMove(int row, int col, int val) {
+    const Move m = Move::make(row * SudokuEngine::MaxSize + col, board[row][col], val);
+    applyToBoard(m);
+    journal.record(m);
+    dirty = true;
+}
+
+void MainWindow::refreshCell(int row, int col) {
+    QTableWidgetItem *item = table->item(row, col);
+    if (!item) return;
+
+    const int val = board[row][col];
+    item->setText(val ? QString::number(val) : QString());
+    item->setBackground(QColor(val ? "#14532d" : "#020617"));
+}
 
-    // row check
-    for (int c = 0; c < currentSize; ++c) {
-        if (c == col) continue;
-        if (grid[row][c] == val) return false;
+void MainWindow::jumpToMove(size_t position) {
+    QSignalBlocker blocker(table);
+    journal.seek(position, [this](const Move &m) {
+        applyToBoard(m);
+        refreshCell(m.cell / SudokuEngine::MaxSize, m.cell % SudokuEngine::MaxSize);
+    });
+    dirty = true;
+    updateUndoButtons();
+}
+
+void MainWindow::updateUndoButtons() {
+    undoButton->setEnabled(!gameOver && journal.canUndo());
+    redoButton->setEnabled(!gameOver && journal.canRedo());
+}
+
+void MainWindow::showElapsed() {
+    int m = elapsedSeconds / 60;
+    int s = elapsedSeconds % 60;
+    timerLabel->setText(
+        QString("Time: %1:%2")
+            .arg(m, 2, 10, QLatin1Char('0'))
+            .arg(s, 2, 10, QLatin1Char('0')));
+}
+
+// ================= autosave =================
+
+GameSnapshot MainWindow::makeSnapshot() const {
+    GameSnapshot snap;
+    snap.size = currentSize;
+    snap.elapsedSeconds = static_cast<uint32_t>(elapsedSeconds);
+    snap.gameOver = gameOver;
+    for (int r = 0; r < SudokuEngine::MaxSize; ++r) {
+        for (int c = 0; c < SudokuEngine::MaxSize; ++c) {
+            snap.board[r][c] = board[r][c];
+            snap.given[r][c] = given[r][c];
+            snap.wrongAttempts[r][c] = static_cast<uint8_t>(wrongAttempts[r][c]);
+        }
     }
+    snap.history = journal.history();
+    snap.historyPosition = journal.position();
+    snap.replay = journal.replay();
+    return snap;
+}
 
-    // column check
-    for (int r = 0; r < currentSize; ++r) {
-        if (r == row) continue;
-        if (grid[r][col] == val) return false;
+// snapshotting is a few hundred bytes of copying; the write itself happens
+// on the autosave thread
+void MainWindow::saveIfDirty() {
+    if (!dirty) return;
+    dirty = false;
+    autosave->submit(makeSnapshot().encode());
+}
+
+bool MainWindow::restoreSnapshot() {
+    QFile file(autosavePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const QByteArray bytes = file.readAll();
+    file.close();
+
+    GameSnapshot snap;
+    if (!snap.decode(reinterpret_cast<const uint8_t *>(bytes.constData()),
+                     static_cast<size_t>(bytes.size())))
+        return false;
+    if (snap.gameOver) return false;   // nothing to resume
+
+    // a full board is a solved game, even if saved before Solve ended it
+    bool full = true;
+    for (int r = 0; r < snap.size && full; ++r)
+        for (int c = 0; c < snap.size && full; ++c)
+            full = snap.board[r][c] != 0;
+    if (full) return false;
+
+    // the snapshot has the whole board, so no puzzle is generated here
+    difficultyBox->setCurrentText(snap.size == 6 ? "Easy"
+                                  : snap.size == 9 ? "Medium" : "Hard");
+    setupBoardForCurrentDifficulty();
+    gameOver = false;
+
+    QSignalBlocker blocker(table);
+    for (int r = 0; r < SudokuEngine::MaxSize; ++r) {
+        for (int c = 0; c < SudokuEngine::MaxSize; ++c) {
+            board[r][c] = snap.board[r][c];
+            given[r][c] = snap.given[r][c];
+            wrongAttempts[r][c] = snap.wrongAttempts[r][c];
+        }
     }
 
-    // box check
-    int startRow = (row / boxRows) * boxRows;
-    int startCol = (col / boxCols) * boxCols;
-    for (int r = 0; r < boxRows; ++r) {
-        for (int c = 0; c < boxCols; ++c) {
-            int rr = startRow + r;
-            int cc = startCol + c;
-            if (rr == row && cc == col) continue;
-            if (grid[rr][cc] == val) return false;
+    for (int r = 0; r < currentSize; ++r) {
+        for (int c = 0; c < currentSize; ++c) {
+            QTableWidgetItem *item = table->item(r, c);
+            if (given[r][c]) {
+                item->setText(QString::number(board[r][c]));
+                item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+                item->setForeground(QColor("#22c55e"));
+                item->setBackground(QColor("#0f172a"));
+            } else {
+                item->setFlags(item->flags() | Qt::ItemIsEditable);
+                item->setForeground(QColor("#e5e7eb"));
+                refreshCell(r, c);
+            }
         }
     }
+    rebuildMasks();
+
+    journal.restore(std::move(snap.history), snap.historyPosition,
+                    std::move(snap.replay));
+    updateUndoButtons();
 
+    elapsedSeconds = static_cast<int>(snap.elapsedSeconds);
+    showElapsed();
+    dirty = false;
+
+    statusLabel->setText("Game restored");
     return true;
 }
 
@@ -483,7 +653,7 @@ void MainWindow::onStartClicked() {
     stack->setCurrentWidget(gamePage);
 
     elapsedSeconds = 0;
-    timerLabel->setText("Time: 00:00");
+    showElapsed();
     gameTimer->start(1000);
 
     for (int r = 0; r < SudokuEngine::MaxSize; ++r)
@@ -509,6 +679,9 @@ void MainWindow::onSolve() {
     syncFromUiToEngine();
     if (engine.solve(currentSize)) {
         syncFromEngineToUi();
+        journal.clear();
+        finishGame();
+        dirty = true;
         statusLabel->setText("Solved!");
     } else {
         QMessageBox::warning(this, "Sudoku Solver",
@@ -520,28 +693,38 @@ void MainWindow::onCellChanged(int row, int col) {
     QTableWidgetItem *item = table->item(row, col);
     if (!item) return;
 
+    // everything below edits the item itself; don't re-enter
+    QSignalBlocker blocker(table);
+
+    const int oldVal = board[row][col];
     const QString txt = item->text().trimmed();
 
     if (txt.isEmpty()) {
+        if (oldVal != 0) commitMove(row, col, 0);
         item->setBackground(QColor("#020617"));
         statusLabel->setText("Cell cleared.");
+        updateUndoButtons();
         return;
     }
 
     bool ok = false;
     int val = txt.toInt(&ok);
     if (!ok || val < 1 || val > currentSize) {
+        if (oldVal != 0) commitMove(row, col, 0);
         item->setText("");
         item->setBackground(QColor("#020617"));
         statusLabel->setText("Enter value in range.");
+        updateUndoButtons();
         return;
     }
 
     if (isUserMoveValid(row, col, val)) {
+        if (val != oldVal) commitMove(row, col, val);
         item->setBackground(QColor("#14532d"));
         statusLabel->setText("Nice move!");
     } else {
         ++wrongAttempts[row][col];
+        dirty = true;
 
         item->setBackground(QColor("#b91c1c"));
         statusLabel->setText(
@@ -549,20 +732,12 @@ void MainWindow::onCellChanged(int row, int col) {
                 .arg(wrongAttempts[row][col])
                 .arg(MaxWrongPerCell));
 
+        if (oldVal != 0) commitMove(row, col, 0);
         item->setText("");
         item->setBackground(QColor("#020617"));
 
         if (wrongAttempts[row][col] >= MaxWrongPerCell) {
-            gameTimer->stop();
-
-            for (int r = 0; r < currentSize; ++r) {
-                for (int c2 = 0; c2 < currentSize; ++c2) {
-                    if (QTableWidgetItem *it = table->item(r, c2)) {
-                        it->setFlags(it->flags() & ~Qt::ItemIsEditable);
-                    }
-                }
-            }
-
+            finishGame();
             statusLabel->setText("Game over");
             QMessageBox::information(
                 this,
@@ -570,4 +745,33 @@ void MainWindow::onCellChanged(int row, int col) {
                 "Game over. Click \"New Game\" to try again.");
         }
     }
+    updateUndoButtons();
+}
+
+// solved or lost: the clock stops, the board locks and the autosave is not
+// resumed on the next start
+void MainWindow::finishGame() {
+    gameTimer->stop();
+    gameOver = true;
+
+    for (int r = 0; r < currentSize; ++r) {
+        for (int c = 0; c < currentSize; ++c) {
+            if (QTableWidgetItem *it = table->item(r, c)) {
+                it->setFlags(it->flags() & ~Qt::ItemIsEditable);
+            }
+        }
+    }
+    updateUndoButtons();
+}
+
+void MainWindow::onUndo() {
+    if (gameOver || !journal.canUndo()) return;
+    jumpToMove(journal.position() - 1);
+    statusLabel->setText("Move undone.");
+}
+
+void MainWindow::onRedo() {
+    if (gameOver || !journal.canRedo()) return;
+    jumpToMove(journal.position() + 1);
+    statusLabel->setText("Move redone.");
 }
@@ -8,6 +8,12 @@
 #include <QLabel>
 #include <QTimer>
 
+#include <cstdint>
+#include <memory>
+
+#include "AutosaveWriter.h"
+#include "GameSnapshot.h"
+#include "MoveJournal.h"
 #include "SudokuEngine.h"
 
 class MainWindow : public QMainWindow {
@@ -15,6 +21,7 @@ class MainWindow : public QMainWindow {
 
 public:
     explicit MainWindow(QWidget *parent = nullptr);
+    ~MainWindow() override;
 
 private:
     QStackedWidget *stack;
@@ -28,17 +35,37 @@ private:
     QPushButton *newGameButton;
     QPushButton *solveButton;
     QPushButton *changeLevelButton;   // <-- ADD THIS
+    QPushButton *undoButton;
+    QPushButton *redoButton;
     QLabel *statusLabel;
     QLabel *timerLabel;
 
     QTimer *gameTimer;
     int elapsedSeconds = 0;
 
+    // autosave: state is snapshotted at most every AutosaveIntervalMs while
+    // dirty and written out by the background writer
+    static constexpr int AutosaveIntervalMs = 3000;
+    QTimer *autosaveTimer;
+    QString autosavePath;
+    std::unique_ptr<AutosaveWriter> autosave;
+    bool dirty = false;
+
     static constexpr int MaxWrongPerCell = 5;
     int wrongAttempts[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
 
     SudokuEngine engine;
 
+    // the board as the player sees it; row/column/box value masks are kept
+    // in step so move checks and undo/redo never rescan the table
+    uint8_t board[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    bool given[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    uint16_t rowMask[SudokuEngine::MaxSize]{};
+    uint16_t colMask[SudokuEngine::MaxSize]{};
+    uint16_t boxMask[SudokuEngine::MaxSize]{};
+    MoveJournal journal;
+    bool gameOver = false;
+
     int currentSize = 9;   // 6, 9, or 12
     int boxRows = 3;
     int boxCols = 3;
@@ -48,14 +75,31 @@ private:
     void setupGamePage();
 
     void loadRandomPuzzle(const QString &diff);
+    void setupBoardForCurrentDifficulty();
     void loadPuzzleForCurrentDifficulty();
+    void finishGame();
     void syncFromEngineToUi();
     void syncFromUiToEngine();
     bool isUserMoveValid(int row, int col, int val) const;
 
+    int boxOf(int row, int col) const;
+    void rebuildMasks();
+    void applyToBoard(const Move &m);
+    void commitMove(int row, int col, int val);
+    void refreshCell(int row, int col);
+    void jumpToMove(size_t position);
+    void updateUndoButtons();
+    void showElapsed();
+
+    GameSnapshot makeSnapshot() const;
+    bool restoreSnapshot();
+    void saveIfDirty();
+
 private slots:
     void onStartClicked();
     void onNewGame();
     void onSolve();
     void onCellChanged(int row, int col);
+    void onUndo();
+    void onRedo();
 };
@@ -0,0 +1,45 @@
+#include "MoveJournal.h"
+
+#include <utility>
+
+// ---------------- Move ----------------
+
+Move Move::make(int cell, int oldValue, int newValue) {
+    Move m;
+    m.cell = static_cast<uint8_t>(cell);
+    m.oldValue = static_cast<uint8_t>(oldValue);
+    m.newValue = static_cast<uint8_t>(newValue);
+    // bit 0 stands for "empty" and never lives in a mask
+    m.maskDelta = static_cast<uint16_t>(((1u << oldValue) ^ (1u << newValue)) & ~1u);
+    return m;
+}
+
+Move Move::inverse() const {
+    Move m = *this;
+    m.oldValue = newValue;
+    m.newValue = oldValue;
+    return m;
+}
+
+// ---------------- MoveJournal ----------------
+
+void MoveJournal::clear() {
+    moves.clear();
+    replayLog.clear();
+    cursor = 0;
+}
+
+void MoveJournal::record(const Move &m) {
+    moves.resize(cursor);
+    moves.push_back(m);
+    ++cursor;
+    replayLog.push_back(m);
+}
+
+
+void MoveJournal::restore(std::vector<Move> history, size_t position,
+                          std::vector<Move> replay) {
+    moves = std::move(history);
+    replayLog = std::move(replay);
+    cursor = position > moves.size() ? moves.size() : position;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One board edit. maskDelta holds the value bits that flip in the cell's
+// row/column/box masks, so applying or reverting the move is a single XOR
+// per mask.
+struct Move {
+    uint8_t  cell;        // row * SudokuEngine::MaxSize + col
+    uint8_t  oldValue;
+    uint8_t  newValue;
+    uint8_t  reserved = 0;
+    uint16_t maskDelta;
+
+    static Move make(int cell, int oldValue, int newValue);
+    Move inverse() const;
+};
+
+// Undo/redo history of player moves plus an append-only replay log of
+// every change that hit the board (moves, undos and redos alike).
+class MoveJournal {
+public:
+    void clear();
+
+    // drops any redo tail, then appends
+    void record(const Move &m);
+
+    size_t position() const { return cursor; }
+    size_t size() const { return moves.size(); }
+    bool canUndo() const { return cursor > 0; }
+    bool canRedo() const { return cursor < moves.size(); }
+
+    // walks the history to target in O(|target - position()|), calling
+    // apply(move) with each move to perform; moves walked backwards are
+    // passed already inverted
+    template <typename Apply>
+    void seek(size_t target, Apply apply) {
+        if (target > moves.size()) target = moves.size();
+        while (cursor > target) {
+            Move m = moves[--cursor].inverse();
+            replayLog.push_back(m);
+            apply(m);
+        }
+        while (cursor < target) {
+            const Move &m = moves[cursor++];
+            replayLog.push_back(m);
+            apply(m);
+        }
+    }
+
+    const std::vector<Move> &history() const { return moves; }
+    const std::vector<Move> &replay() const { return replayLog; }
+
+    // puts back a saved journal as-is
+    void restore(std::vector<Move> history, size_t position,
+                 std::vector<Move> replay);
+
+private:
+    std::vector<Move> moves;
+    std::vector<Move> replayLog;
+    size_t cursor = 0;
+};
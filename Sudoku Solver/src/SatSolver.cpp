@@ -0,0 +1,439 @@
+#include "SatSolver.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+constexpr double VarDecay    = 0.95;
+constexpr double ClauseDecay = 0.999;
+constexpr int RestartBase    = 100;   // conflicts per Luby unit
+
+// Luby restart sequence: 1 1 2 1 1 2 4 1 1 2 ...
+double luby(double y, long long x) {
+    long long size = 1;
+    int seq = 0;
+    while (size < x + 1) {
+        ++seq;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != x) {
+        size = (size - 1) >> 1;
+        --seq;
+        x = x % size;
+    }
+    double r = 1.0;
+    for (int i = 0; i < seq; ++i) r *= y;
+    return r;
+}
+
+} // namespace
+
+// ---------------- constructor ----------------
+
+SatSolver::SatSolver() = default;
+
+// ---------------- problem setup ----------------
+
+int SatSolver::toLit(int dimacs) {
+    int v = std::abs(dimacs) - 1;
+    return 2 * v + (dimacs < 0 ? 1 : 0);
+}
+
+int SatSolver::newVar() {
+    int v = numVars();
+    assigns.push_back(Undef);
+    polarity.push_back(1);
+    level.push_back(0);
+    reason.push_back(-1);
+    seen.push_back(0);
+    activity.push_back(0.0);
+    heapPos.push_back(-1);
+    watches.emplace_back();
+    watches.emplace_back();
+    heapInsert(v);
+    return v + 1;
+}
+
+bool SatSolver::addClause(std::vector<int> lits) {
+    if (!ok) return false;
+
+    for (int &l : lits) l = toLit(l);
+    std::sort(lits.begin(), lits.end());
+
+    // drop duplicates and level-0 false literals; skip tautologies and
+    // clauses already satisfied at level 0
+    size_t j = 0;
+    int prev = -1;
+    for (size_t i = 0; i < lits.size(); ++i) {
+        int l = lits[i];
+        uint8_t val = litValue(l);
+        if (val == True || l == (prev ^ 1)) return true;
+        if (val != False && l != prev) {
+            lits[j++] = l;
+            prev = l;
+        }
+    }
+    lits.resize(j);
+
+    if (lits.empty()) {
+        ok = false;
+        return false;
+    }
+    if (lits.size() == 1) {
+        enqueue(lits[0], -1);
+        return true;
+    }
+    attachClause(std::move(lits), false);
+    return true;
+}
+
+int SatSolver::attachClause(std::vector<int> lits, bool learnt) {
+    int cref = static_cast<int>(clauses.size());
+    watches[lits[0] ^ 1].push_back({cref, lits[1]});
+    watches[lits[1] ^ 1].push_back({cref, lits[0]});
+
+    Clause c;
+    c.lits = std::move(lits);
+    c.learnt = learnt;
+    clauses.push_back(std::move(c));
+    if (learnt) learnts.push_back(cref);
+    return cref;
+}
+
+// ---------------- propagation ----------------
+
+void SatSolver::enqueue(int lit, int from) {
+    int v = lit >> 1;
+    assigns[v] = static_cast<uint8_t>((lit & 1) ? False : True);
+    level[v] = decisionLevel();
+    reason[v] = from;
+    trail.push_back(lit);
+}
+
+// returns the conflicting clause, or -1
+int SatSolver::propagate() {
+    int confl = -1;
+
+    while (qhead < trail.size()) {
+        int p = trail[qhead++];          // p just became true
+        int falseLit = p ^ 1;
+        std::vector<Watcher> &ws = watches[p];
+
+        size_t i = 0, j = 0;
+        while (i < ws.size()) {
+            Watcher w = ws[i];
+            if (litValue(w.blocker) == True) {
+                ws[j++] = ws[i++];
+                continue;
+            }
+
+            Clause &c = clauses[w.cref];
+            if (c.deleted) {
+                ++i;                     // drop stale watcher
+                continue;
+            }
+
+            std::vector<int> &lits = c.lits;
+            if (lits[0] == falseLit) std::swap(lits[0], lits[1]);
+            ++i;
+
+            int first = lits[0];
+            Watcher nw{w.cref, first};
+            if (first != w.blocker && litValue(first) == True) {
+                ws[j++] = nw;
+                continue;
+            }
+
+            // look for a new literal to watch
+            bool moved = false;
+            for (size_t k = 2; k < lits.size(); ++k) {
+                if (litValue(lits[k]) != False) {
+                    lits[1] = lits[k];
+                    lits[k] = falseLit;
+                    watches[lits[1] ^ 1].push_back(nw);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) continue;
+
+            // clause is unit or conflicting
+            ws[j++] = nw;
+            if (litValue(first) == False) {
+                confl = w.cref;
+                qhead = trail.size();
+                while (i < ws.size()) ws[j++] = ws[i++];
+            } else {
+                enqueue(first, w.cref);
+            }
+        }
+        ws.resize(j);
+
+        if (confl != -1) break;
+    }
+    return confl;
+}
+
+// ---------------- conflict analysis ----------------
+
+void SatSolver::analyze(int confl, std::vector<int> &outLearnt, int &outLevel) {
+    int pathCount = 0;
+    int p = -1;
+    int index = static_cast<int>(trail.size()) - 1;
+
+    outLearnt.push_back(-1);   // room for the asserting literal
+
+    do {
+        Clause &c = clauses[confl];
+        if (c.learnt) bumpClause(c);
+
+        for (size_t j = (p == -1 ? 0 : 1); j < c.lits.size(); ++j) {
+            int q = c.lits[j];
+            int v = q >> 1;
+            if (!seen[v] && level[v] > 0) {
+                bumpVar(v);
+                seen[v] = 1;
+                if (level[v] >= decisionLevel())
+                    ++pathCount;
+                else
+                    outLearnt.push_back(q);
+            }
+        }
+
+        // next literal of the current level on the trail
+        while (!seen[trail[index--] >> 1]) {}
+        p = trail[index + 1];
+        confl = reason[p >> 1];
+        seen[p >> 1] = 0;
+        --pathCount;
+    } while (pathCount > 0);
+
+    outLearnt[0] = p ^ 1;
+
+    // drop literals implied by the rest of the clause
+    std::vector<int> toClear(outLearnt.begin() + 1, outLearnt.end());
+    size_t j = 1;
+    for (size_t i = 1; i < outLearnt.size(); ++i) {
+        if (reason[outLearnt[i] >> 1] == -1 || !litRedundant(outLearnt[i]))
+            outLearnt[j++] = outLearnt[i];
+    }
+    outLearnt.resize(j);
+
+    // the highest remaining level goes to slot 1 so it gets watched
+    outLevel = 0;
+    if (outLearnt.size() > 1) {
+        size_t maxI = 1;
+        for (size_t i = 2; i < outLearnt.size(); ++i) {
+            if (level[outLearnt[i] >> 1] > level[outLearnt[maxI] >> 1])
+                maxI = i;
+        }
+        std::swap(outLearnt[1], outLearnt[maxI]);
+        outLevel = level[outLearnt[1] >> 1];
+    }
+
+    for (int l : toClear) seen[l >> 1] = 0;
+}
+
+// local minimization: lit is redundant if every other literal of its reason
+// is already in the learnt clause or fixed at level 0
+bool SatSolver::litRedundant(int lit) const {
+    const Clause &c = clauses[reason[lit >> 1]];
+    for (size_t k = 1; k < c.lits.size(); ++k) {
+        int v = c.lits[k] >> 1;
+        if (!seen[v] && level[v] > 0) return false;
+    }
+    return true;
+}
+
+void SatSolver::cancelUntil(int lvl) {
+    if (decisionLevel() <= lvl) return;
+
+    for (int i = static_cast<int>(trail.size()) - 1; i >= trailLim[lvl]; --i) {
+        int v = trail[i] >> 1;
+        assigns[v] = Undef;
+        reason[v] = -1;
+        polarity[v] = static_cast<uint8_t>(trail[i] & 1);
+        if (heapPos[v] < 0) heapInsert(v);
+    }
+    trail.resize(trailLim[lvl]);
+    trailLim.resize(lvl);
+    qhead = trail.size();
+}
+
+// ---------------- search ----------------
+
+int SatSolver::pickBranchLit() {
+    while (!heap.empty()) {
+        int v = heapPop();
+        if (assigns[v] == Undef) return 2 * v + polarity[v];
+    }
+    return -1;
+}
+
+SatSolver::Result SatSolver::search(long long restartConflicts,
+                                    long long conflictLimit) {
+    long long localConflicts = 0;
+    std::vector<int> learnt;
+
+    for (;;) {
+        int confl = propagate();
+        if (confl != -1) {
+            ++numConflicts;
+            ++localConflicts;
+            if (decisionLevel() == 0) return Result::Unsat;
+
+            learnt.clear();
+            int btLevel = 0;
+            analyze(confl, learnt, btLevel);
+            cancelUntil(btLevel);
+
+            if (learnt.size() == 1) {
+                enqueue(learnt[0], -1);
+            } else {
+                int cref = attachClause(learnt, true);
+                bumpClause(clauses[cref]);
+                enqueue(learnt[0], cref);
+            }
+
+            varInc /= VarDecay;
+            clauseInc /= ClauseDecay;
+            continue;
+        }
+
+        if (localConflicts >= restartConflicts ||
+            (conflictLimit >= 0 && numConflicts >= conflictLimit)) {
+            cancelUntil(0);
+            return Result::Unknown;
+        }
+
+        if (static_cast<double>(learnts.size()) - trail.size() >= maxLearnts)
+            reduceLearnts();
+
+        int next = pickBranchLit();
+        if (next == -1) {
+            model = assigns;
+            return Result::Sat;
+        }
+        ++numDecisions;
+        trailLim.push_back(static_cast<int>(trail.size()));
+        enqueue(next, -1);
+    }
+}
+
+SatSolver::Result SatSolver::solve(long long conflictLimit) {
+    model.clear();
+    if (!ok) return Result::Unsat;
+
+    maxLearnts = std::max(clauses.size() / 3.0, 1000.0);
+
+    Result result = Result::Unknown;
+    for (long long restarts = 0; result == Result::Unknown; ++restarts) {
+        long long budget =
+            static_cast<long long>(luby(2.0, restarts) * RestartBase);
+        result = search(budget, conflictLimit);
+        if (conflictLimit >= 0 && numConflicts >= conflictLimit) break;
+        maxLearnts *= 1.1;
+    }
+
+    if (result == Result::Unsat) ok = false;
+    cancelUntil(0);
+    return result;
+}
+
+// ---------------- learnt clause database ----------------
+
+bool SatSolver::locked(int cref) const {
+    const Clause &c = clauses[cref];
+    int v = c.lits[0] >> 1;
+    return reason[v] == cref && litValue(c.lits[0]) == True;
+}
+
+void SatSolver::reduceLearnts() {
+    std::sort(learnts.begin(), learnts.end(), [this](int a, int b) {
+        const Clause &ca = clauses[a];
+        const Clause &cb = clauses[b];
+        if ((ca.lits.size() > 2) != (cb.lits.size() > 2))
+            return ca.lits.size() > 2;
+        return ca.activity < cb.activity;
+    });
+
+    // delete the less active half; binary and locked clauses stay
+    size_t half = learnts.size() / 2;
+    size_t j = 0;
+    for (size_t i = 0; i < learnts.size(); ++i) {
+        Clause &c = clauses[learnts[i]];
+        if (i < half && c.lits.size() > 2 && !locked(learnts[i])) {
+            c.deleted = true;
+            std::vector<int>().swap(c.lits);
+        } else {
+            learnts[j++] = learnts[i];
+        }
+    }
+    learnts.resize(j);
+}
+
+// ---------------- VSIDS ----------------
+
+void SatSolver::bumpVar(int v) {
+    activity[v] += varInc;
+    if (activity[v] > 1e100) {
+        for (double &a : activity) a *= 1e-100;
+        varInc *= 1e-100;
+    }
+    if (heapPos[v] >= 0) heapUp(heapPos[v]);
+}
+
+void SatSolver::bumpClause(Clause &c) {
+    c.activity += clauseInc;
+    if (c.activity > 1e20) {
+        for (int cref : learnts) clauses[cref].activity *= 1e-20;
+        clauseInc *= 1e-20;
+    }
+}
+
+void SatSolver::heapInsert(int v) {
+    heapPos[v] = static_cast<int>(heap.size());
+    heap.push_back(v);
+    heapUp(heapPos[v]);
+}
+
+int SatSolver::heapPop() {
+    int top = heap[0];
+    heap[0] = heap.back();
+    heapPos[heap[0]] = 0;
+    heap.pop_back();
+    heapPos[top] = -1;
+    if (!heap.empty()) heapDown(0);
+    return top;
+}
+
+void SatSolver::heapUp(int i) {
+    int v = heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (activity[heap[parent]] >= activity[v]) break;
+        heap[i] = heap[parent];
+        heapPos[heap[i]] = i;
+        i = parent;
+    }
+    heap[i] = v;
+    heapPos[v] = i;
+}
+
+void SatSolver::heapDown(int i) {
+    int v = heap[i];
+    int n = static_cast<int>(heap.size());
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && activity[heap[child + 1]] > activity[heap[child]])
+            ++child;
+        if (activity[heap[child]] <= activity[v]) break;
+        heap[i] = heap[child];
+        heapPos[heap[i]] = i;
+        i = child;
+    }
+    heap[i] = v;
+    heapPos[v] = i;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Small self-contained CDCL SAT solver used as an alternative SudokuEngine
+// backend: two watched literals, VSIDS branching, phase saving, Luby
+// restarts and first-UIP clause learning.
+class SatSolver {
+public:
+    enum class Result { Sat, Unsat, Unknown };
+
+    SatSolver();
+
+    // variables are numbered from 1; clauses use DIMACS signs (+v / -v)
+    int newVar();
+    int numVars() const { return static_cast<int>(assigns.size()); }
+
+    // only valid between solve() calls; returns false once the formula is
+    // known to be unsatisfiable
+    bool addClause(std::vector<int> lits);
+
+    // conflictLimit < 0 means "run until decided"
+    Result solve(long long conflictLimit = -1);
+
+    // value of variable v in the last model found by solve()
+    bool modelValue(int v) const { return model[v - 1] != 0; }
+
+    long long conflicts() const { return numConflicts; }
+    long long decisions() const { return numDecisions; }
+
+private:
+    // internal literal encoding: 2 * var + sign, var counted from 0
+    static int toLit(int dimacs);
+
+    static constexpr uint8_t False = 0;
+    static constexpr uint8_t True  = 1;
+    static constexpr uint8_t Undef = 2;
+
+    struct Clause {
+        std::vector<int> lits;
+        double activity = 0.0;
+        bool learnt = false;
+        bool deleted = false;
+    };
+
+    struct Watcher {
+        int cref;
+        int blocker;
+    };
+
+    bool ok = true;
+
+    std::vector<Clause> clauses;
+    std::vector<int> learnts;                   // crefs of learnt clauses
+    std::vector<std::vector<Watcher>> watches;  // indexed by literal
+
+    std::vector<uint8_t> assigns;   // per var: False / True / Undef
+    std::vector<uint8_t> polarity;  // saved phase, 1 == negative
+    std::vector<int> level;
+    std::vector<int> reason;        // cref or -1
+    std::vector<uint8_t> seen;
+    std::vector<uint8_t> model;
+
+    std::vector<int> trail;
+    std::vector<int> trailLim;
+    size_t qhead = 0;
+
+    // VSIDS
+    std::vector<double> activity;
+    std::vector<int> heap;          // binary max-heap of vars
+    std::vector<int> heapPos;       // -1 if not in heap
+    double varInc = 1.0;
+    double clauseInc = 1.0;
+
+    long long numConflicts = 0;
+    long long numDecisions = 0;
+    double maxLearnts = 0.0;
+
+    uint8_t litValue(int lit) const {
+        uint8_t v = assigns[lit >> 1];
+        return v == Undef ? Undef : static_cast<uint8_t>(v ^ (lit & 1));
+    }
+    int decisionLevel() const { return static_cast<int>(trailLim.size()); }
+
+    void enqueue(int lit, int from);
+    int propagate();
+    void analyze(int confl, std::vector<int> &outLearnt, int &outLevel);
+    bool litRedundant(int lit) const;
+    void cancelUntil(int lvl);
+    int pickBranchLit();
+    Result search(long long restartConflicts, long long conflictLimit);
+
+    int attachClause(std::vector<int> lits, bool learnt);
+    void reduceLearnts();
+    bool locked(int cref) const;
+
+    void bumpVar(int v);
+    void bumpClause(Clause &c);
+
+    void heapInsert(int v);
+    int heapPop();
+    void heapUp(int i);
+    void heapDown(int i);
+};
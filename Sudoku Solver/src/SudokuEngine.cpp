@@ -1,9 +1,15 @@
 #include "SudokuEngine.h"
+#include "CageTables.h"
+#include "SatSolver.h"
+
+#include <utility>
+#include <vector>
 
 // ---------------- constructor ----------------
 
 SudokuEngine::SudokuEngine() {
     // arrays are zero-initialized by default
+    clearCages();
 }
 
 // ---------------- helpers ----------------
@@ -22,10 +28,8 @@ bool SudokuEngine::canPlace(int r, int c, int val) const {
     return true;
 }
 
-// ---------------- public API ----------------
-
-void SudokuEngine::loadPuzzle(const int src[MaxSize][MaxSize], int size) {
-    // set currentSize and box shape based on size
+// set currentSize and box shape based on size
+void SudokuEngine::setShape(int size) {
     currentSize = size;
     if (currentSize == 6) {
         boxRows = 2;
@@ -37,6 +41,27 @@ void SudokuEngine::loadPuzzle(const int src[MaxSize][MaxSize], int size) {
         boxRows = 3;
         boxCols = 4;
     }
+}
+
+void SudokuEngine::place(int r, int c, int val) {
+    grid[r][c] = val;
+    rowUsed[r][val] = true;
+    colUsed[c][val] = true;
+    boxUsed[boxIndex(r, c)][val] = true;
+}
+
+void SudokuEngine::unplace(int r, int c, int val) {
+    grid[r][c] = 0;
+    rowUsed[r][val] = false;
+    colUsed[c][val] = false;
+    boxUsed[boxIndex(r, c)][val] = false;
+}
+
+// ---------------- public API ----------------
+
+bool SudokuEngine::loadPuzzle(const int src[MaxSize][MaxSize], int size) {
+    setShape(size);
+    bool consistent = true;
 
     std::memset(grid,     0, sizeof(grid));
     std::memset(rowUsed,  0, sizeof(rowUsed));
@@ -48,12 +73,21 @@ void SudokuEngine::loadPuzzle(const int src[MaxSize][MaxSize], int size) {
             grid[r][c] = src[r][c];
             int val = grid[r][c];
             if (val != 0) {
+                if (!canPlace(r, c, val)) consistent = false;
                 rowUsed[r][val] = true;
                 colUsed[c][val] = true;
                 boxUsed[boxIndex(r, c)][val] = true;
             }
         }
     }
+    clearCages();
+    return consistent;
+}
+
+bool SudokuEngine::loadPuzzle(const int src[MaxSize][MaxSize], int size,
+                              const std::vector<Cage> &cages) {
+    bool consistent = loadPuzzle(src, size);
+    return buildCages(cages) && consistent;
 }
 
 void SudokuEngine::getGrid(int dest[MaxSize][MaxSize]) const {
@@ -67,9 +101,57 @@ void SudokuEngine::getGrid(int dest[MaxSize][MaxSize]) const {
 bool SudokuEngine::solve(int size) {
     currentSize = size;
     // boxRows/boxCols already set in loadPuzzle
+    if (cageCount > 0 || backend == Backend::Masks) {
+        // neither the row-major backtracker nor the CNF know about sums
+        return searchMasks(1, true) == 1;
+    }
+    if (backend == Backend::Sat) {
+        return solveSat();
+    }
     return solveRecursive(0, 0);
 }
 
+int SudokuEngine::countSolutions(int limit) {
+    if (limit <= 0) return 0;
+    return searchMasks(limit, false);
+}
+
+void SudokuEngine::generate(int size, uint32_t seed, int targetGivens) {
+    setShape(size);
+    std::memset(grid,     0, sizeof(grid));
+    std::memset(rowUsed,  0, sizeof(rowUsed));
+    std::memset(colUsed,  0, sizeof(colUsed));
+    std::memset(boxUsed,  0, sizeof(boxUsed));
+    clearCages();
+
+    uint32_t rng = seed ? seed : 0x9e3779b9u;
+    fillRandom(0, rng);
+
+    // visit cells in random order, keeping each removal only if the
+    // puzzle stays uniquely solvable
+    int order[MaxSize * MaxSize];
+    const int cells = currentSize * currentSize;
+    for (int i = 0; i < cells; ++i) order[i] = i;
+    for (int i = cells - 1; i > 0; --i) {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        int j = static_cast<int>(rng % static_cast<uint32_t>(i + 1));
+        int tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+    }
+
+    int givens = cells;
+    for (int i = 0; i < cells && givens > targetGivens; ++i) {
+        int r = order[i] / currentSize;
+        int c = order[i] % currentSize;
+        int val = grid[r][c];
+        unplace(r, c, val);
+        if (searchMasks(2, false) == 1) {
+            --givens;
+        } else {
+            place(r, c, val);
+        }
+    }
+}
+
 // ---------------- backtracking core ----------------
 
 bool SudokuEngine::solveRecursive(int r, int c) {
@@ -109,3 +191,356 @@ bool SudokuEngine::solveRecursive(int r, int c) {
     }
     return false; // no value fits here
 }
+
+// ---------------- killer cages ----------------
+
+void SudokuEngine::clearCages() {
+    for (auto &row : cageOf)
+        for (auto &cell : row) cell = -1;
+    cageCount = 0;
+    cageAllowed.clear();
+}
+
+// Expands the compile-time (count, sum) -> digit sets table into one
+// used-mask -> allowed-digits row per cage: for every digit set S that fits
+// the cage and every subset U of S already placed, the rest of S stays open.
+bool SudokuEngine::buildCages(const std::vector<Cage> &cages) {
+    clearCages();
+    bool valid = static_cast<int>(cages.size()) <= currentSize * currentSize;
+
+    for (size_t i = 0; valid && i < cages.size(); ++i) {
+        const Cage &cage = cages[i];
+        if (cage.cells.empty() || static_cast<int>(cage.cells.size()) > currentSize) {
+            valid = false;
+            break;
+        }
+        for (int cell : cage.cells) {
+            int r = cell / MaxSize;
+            int c = cell % MaxSize;
+            if (cell < 0 || r >= currentSize || c >= currentSize || cageOf[r][c] >= 0) {
+                valid = false;
+                break;
+            }
+            cageOf[r][c] = static_cast<int16_t>(i);
+        }
+    }
+    if (!valid) {
+        clearCages();
+        return false;
+    }
+
+    const uint16_t full = static_cast<uint16_t>(((1u << currentSize) - 1) << 1);
+    const size_t stride = size_t{1} << currentSize;
+    cageCount = static_cast<int>(cages.size());
+    cageAllowed.assign(stride * cages.size(), 0);
+
+    bool feasible = true;
+    for (size_t i = 0; i < cages.size(); ++i) {
+        const Cage &cage = cages[i];
+        uint16_t *allowed = cageAllowed.data() + i * stride;
+        for (uint16_t set : CageTables::combos(static_cast<int>(cage.cells.size()), cage.sum)) {
+            if (set & ~full) continue;
+            // walk every subset of set, including the empty one
+            for (uint16_t used = set;; used = static_cast<uint16_t>((used - 1) & set)) {
+                allowed[used >> 1] |= static_cast<uint16_t>(set & ~used);
+                if (used == 0) break;
+            }
+        }
+
+        uint16_t used = 0;
+        int filled = 0, sum = 0;
+        for (int cell : cage.cells) {
+            int val = grid[cell / MaxSize][cell % MaxSize];
+            if (val == 0) continue;
+            uint16_t bit = static_cast<uint16_t>(1u << val);
+            if (used & bit) feasible = false;
+            used |= bit;
+            ++filled;
+            sum += val;
+        }
+        if (filled == static_cast<int>(cage.cells.size())) {
+            if (sum != cage.sum) feasible = false;
+        } else if (allowed[used >> 1] == 0) {
+            feasible = false;
+        }
+    }
+    return feasible;
+}
+
+// ---------------- mask search ----------------
+
+// Counting and killer solving run on a private bitmask copy of the grid,
+// picking the open cell with the fewest candidates first, so uniqueness
+// checks stay cheap and cage sums prune as early as rows and columns do.
+namespace {
+
+constexpr int Cells = SudokuEngine::MaxSize * SudokuEngine::MaxSize;
+
+struct SearchState {
+    uint16_t row[SudokuEngine::MaxSize];
+    uint16_t col[SudokuEngine::MaxSize];
+    uint16_t box[SudokuEngine::MaxSize];
+    uint8_t  openRow[Cells];
+    uint8_t  openCol[Cells];
+    uint8_t  openBox[Cells];
+    int16_t  openCage[Cells];         // -1 outside any cage
+    uint16_t cage[Cells];             // digits placed per cage
+    const uint16_t *allowed = nullptr;
+    size_t   stride = 0;
+    int      open = 0;
+    uint16_t full = 0;
+
+    // first solution, captured when keepFirst is set
+    bool     keepFirst = false;
+    bool     captured = false;
+    uint8_t  value[Cells];
+    uint8_t  solution[Cells];
+};
+
+int bitCount(uint16_t m) {
+    int n = 0;
+    for (; m; m &= m - 1) ++n;
+    return n;
+}
+
+void swapOpen(SearchState &st, int a, int b) {
+    std::swap(st.openRow[a], st.openRow[b]);
+    std::swap(st.openCol[a], st.openCol[b]);
+    std::swap(st.openBox[a], st.openBox[b]);
+    std::swap(st.openCage[a], st.openCage[b]);
+}
+
+uint16_t candidates(const SearchState &st, int i) {
+    uint16_t cand = st.full & ~(st.row[st.openRow[i]] |
+                                st.col[st.openCol[i]] |
+                                st.box[st.openBox[i]]);
+    const int k = st.openCage[i];
+    if (k >= 0) cand &= st.allowed[k * st.stride + (st.cage[k] >> 1)];
+    return cand;
+}
+
+int countMasks(SearchState &st, int limit) {
+    if (st.open == 0) {
+        if (st.keepFirst && !st.captured) {
+            std::memcpy(st.solution, st.value, sizeof(st.solution));
+            st.captured = true;
+        }
+        return 1;
+    }
+
+    int best = -1;
+    int bestCount = SudokuEngine::MaxSize + 1;
+    uint16_t bestCand = 0;
+    for (int i = 0; i < st.open; ++i) {
+        uint16_t cand = candidates(st, i);
+        int n = bitCount(cand);
+        if (n < bestCount) {
+            bestCount = n;
+            best = i;
+            bestCand = cand;
+            if (n <= 1) break;
+        }
+    }
+    if (bestCount == 0) return 0;
+
+    // move the chosen cell past the end of the open list
+    --st.open;
+    swapOpen(st, best, st.open);
+    const int r = st.openRow[st.open];
+    const int c = st.openCol[st.open];
+    const int b = st.openBox[st.open];
+    const int k = st.openCage[st.open];
+
+    int found = 0;
+    for (uint16_t cand = bestCand; cand && found < limit; cand &= cand - 1) {
+        uint16_t bit = cand & static_cast<uint16_t>(-cand);
+        st.row[r] |= bit;
+        st.col[c] |= bit;
+        st.box[b] |= bit;
+        if (k >= 0) st.cage[k] |= bit;
+        if (st.keepFirst) {
+            int val = 0;
+            while (!(bit >> val & 1)) ++val;
+            st.value[r * SudokuEngine::MaxSize + c] = static_cast<uint8_t>(val);
+        }
+        found += countMasks(st, limit - found);
+        st.row[r] &= ~bit;
+        st.col[c] &= ~bit;
+        st.box[b] &= ~bit;
+        if (k >= 0) st.cage[k] &= ~bit;
+    }
+
+    swapOpen(st, best, st.open);
+    ++st.open;
+    return found;
+}
+
+} // namespace
+
+// keepFirst writes the first solution found back into the grid
+int SudokuEngine::searchMasks(int limit, bool keepFirst) {
+    SearchState st{};
+    st.full = static_cast<uint16_t>(((1u << currentSize) - 1) << 1);
+    st.allowed = cageAllowed.data();
+    st.stride = size_t{1} << currentSize;
+    st.keepFirst = keepFirst;
+    for (int r = 0; r < currentSize; ++r) {
+        for (int c = 0; c < currentSize; ++c) {
+            int b = boxIndex(r, c);
+            int k = cageOf[r][c];
+            if (grid[r][c] == 0) {
+                st.openRow[st.open] = static_cast<uint8_t>(r);
+                st.openCol[st.open] = static_cast<uint8_t>(c);
+                st.openBox[st.open] = static_cast<uint8_t>(b);
+                st.openCage[st.open] = static_cast<int16_t>(k);
+                ++st.open;
+            } else {
+                uint16_t bit = static_cast<uint16_t>(1u << grid[r][c]);
+                st.row[r] |= bit;
+                st.col[c] |= bit;
+                st.box[b] |= bit;
+                if (k >= 0) st.cage[k] |= bit;
+            }
+        }
+    }
+
+    int found = countMasks(st, limit);
+    if (st.captured) {
+        for (int r = 0; r < currentSize; ++r)
+            for (int c = 0; c < currentSize; ++c)
+                if (grid[r][c] == 0) place(r, c, st.solution[r * MaxSize + c]);
+    }
+    return found;
+}
+
+// fill an empty grid in row-major order, trying values in random order
+bool SudokuEngine::fillRandom(int pos, uint32_t &rng) {
+    if (pos == currentSize * currentSize) return true;
+    int r = pos / currentSize;
+    int c = pos % currentSize;
+
+    int vals[MaxSize];
+    for (int i = 0; i < currentSize; ++i) vals[i] = i + 1;
+    for (int i = currentSize - 1; i > 0; --i) {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        int j = static_cast<int>(rng % static_cast<uint32_t>(i + 1));
+        int tmp = vals[i]; vals[i] = vals[j]; vals[j] = tmp;
+    }
+
+    for (int i = 0; i < currentSize; ++i) {
+        if (canPlace(r, c, vals[i])) {
+            place(r, c, vals[i]);
+            if (fillRandom(pos + 1, rng)) return true;
+            unplace(r, c, vals[i]);
+        }
+    }
+    return false;
+}
+
+// ---------------- SAT backend ----------------
+
+namespace {
+
+// at-most-one: pairwise for tiny groups, Sinz sequential counter otherwise
+void addAtMostOne(SatSolver &sat, const std::vector<int> &xs) {
+    const int n = static_cast<int>(xs.size());
+    if (n <= 4) {
+        for (int i = 0; i < n; ++i)
+            for (int j = i + 1; j < n; ++j)
+                sat.addClause({-xs[i], -xs[j]});
+        return;
+    }
+
+    // s[i] <=> "one of xs[0..i] is true"
+    int prev = sat.newVar();
+    sat.addClause({-xs[0], prev});
+    for (int i = 1; i < n - 1; ++i) {
+        int s = sat.newVar();
+        sat.addClause({-xs[i], s});
+        sat.addClause({-prev, s});
+        sat.addClause({-xs[i], -prev});
+        prev = s;
+    }
+    sat.addClause({-xs[n - 1], -prev});
+}
+
+void addExactlyOne(SatSolver &sat, const std::vector<int> &xs) {
+    sat.addClause(xs);
+    addAtMostOne(sat, xs);
+}
+
+} // namespace
+
+// Only open cells get variables, and only for values not already used by a
+// peer, so the CNF shrinks with every given. Each open cell takes exactly one
+// value and each missing value appears exactly once per row, column and box.
+bool SudokuEngine::solveSat() {
+    SatSolver sat;
+    int var[MaxSize][MaxSize][MaxSize + 1]{};   // 0 == no variable
+
+    for (int r = 0; r < currentSize; ++r) {
+        for (int c = 0; c < currentSize; ++c) {
+            if (grid[r][c] != 0) continue;
+
+            std::vector<int> cell;
+            for (int val = 1; val <= currentSize; ++val) {
+                if (canPlace(r, c, val)) {
+                    var[r][c][val] = sat.newVar();
+                    cell.push_back(var[r][c][val]);
+                }
+            }
+            if (cell.empty()) return false;  // dead cell
+            addExactlyOne(sat, cell);
+        }
+    }
+
+    std::vector<int> group;
+    group.reserve(MaxSize);
+    for (int val = 1; val <= currentSize; ++val) {
+        for (int r = 0; r < currentSize; ++r) {
+            if (rowUsed[r][val]) continue;
+            group.clear();
+            for (int c = 0; c < currentSize; ++c)
+                if (var[r][c][val]) group.push_back(var[r][c][val]);
+            if (group.empty()) return false;
+            addExactlyOne(sat, group);
+        }
+        for (int c = 0; c < currentSize; ++c) {
+            if (colUsed[c][val]) continue;
+            group.clear();
+            for (int r = 0; r < currentSize; ++r)
+                if (var[r][c][val]) group.push_back(var[r][c][val]);
+            if (group.empty()) return false;
+            addExactlyOne(sat, group);
+        }
+        for (int br = 0; br < currentSize; br += boxRows) {
+            for (int bc = 0; bc < currentSize; bc += boxCols) {
+                if (boxUsed[boxIndex(br, bc)][val]) continue;
+                group.clear();
+                for (int r = br; r < br + boxRows; ++r)
+                    for (int c = bc; c < bc + boxCols; ++c)
+                        if (var[r][c][val]) group.push_back(var[r][c][val]);
+                if (group.empty()) return false;
+                addExactlyOne(sat, group);
+            }
+        }
+    }
+
+    if (sat.solve() != SatSolver::Result::Sat) {
+        return false;
+    }
+
+    // decode the model back into the grid
+    for (int r = 0; r < currentSize; ++r) {
+        for (int c = 0; c < currentSize; ++c) {
+            if (grid[r][c] != 0) continue;
+            for (int val = 1; val <= currentSize; ++val) {
+                if (var[r][c][val] && sat.modelValue(var[r][c][val])) {
+                    place(r, c, val);
+                    break;
+                }
+            }
+        }
+    }
+    return true;
+}
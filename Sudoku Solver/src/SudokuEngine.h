@@ -1,19 +1,51 @@
 #pragma once
+#include <cstdint>
 #include <cstring>
+#include <vector>
 
 class SudokuEngine {
 public:
     static constexpr int MaxSize = 12;   // supports 6, 9, 12
 
+    // Backtracking: the plain recursive search below.
+    // Sat: encode the grid as CNF and hand it to the built-in CDCL solver.
+    // Masks: most-constrained-cell search over candidate bitmasks, the one
+    // countSolutions() uses.
+    // Killer puzzles ignore the choice and always use the mask search.
+    enum class Backend { Backtracking, Sat, Masks };
+
+    // killer cage: distinct digits in cells adding up to sum
+    struct Cage {
+        int sum = 0;
+        std::vector<int> cells;   // row * MaxSize + col
+    };
+
     SudokuEngine();
 
-    // size must be 6, 9, or 12.
-    void loadPuzzle(const int src[MaxSize][MaxSize], int size);
+    void setBackend(Backend b) { backend = b; }
+    Backend currentBackend() const { return backend; }
+
+    // size must be 6, 9, or 12; values 0..size.
+    // returns false if two givens clash (the grid is still loaded).
+    bool loadPuzzle(const int src[MaxSize][MaxSize], int size);
+
+    // as above, plus killer cages; also returns false for overlapping or
+    // out-of-range cage cells and for givens no cage combination allows
+    bool loadPuzzle(const int src[MaxSize][MaxSize], int size,
+                    const std::vector<Cage> &cages);
     void getGrid(int dest[MaxSize][MaxSize]) const;
 
     // full solve for the current size
     bool solve(int size);
 
+    // number of solutions of the loaded grid, stopping once limit is
+    // reached; the grid itself is left untouched
+    int countSolutions(int limit);
+
+    // replace the grid with a random puzzle that has a unique solution,
+    // removing clues until targetGivens is reached or none can go
+    void generate(int size, uint32_t seed, int targetGivens);
+
 private:
     int grid[MaxSize][MaxSize]{};
 
@@ -27,7 +59,27 @@ private:
     int boxRows = 3;
     int boxCols = 3;
 
+    Backend backend = Backend::Backtracking;
+
+    // cageOf[r][c] is the cage index or -1. cageAllowed holds, per cage, the
+    // digits still placeable for every set of digits already in the cage
+    // (indexed by used mask >> 1), expanded from CageTables at load time so
+    // the search pays one lookup per check.
+    int16_t cageOf[MaxSize][MaxSize]{};
+    int cageCount = 0;
+    std::vector<uint16_t> cageAllowed;
+
     bool solveRecursive(int r, int c);
     bool canPlace(int r, int c, int val) const;
     int boxIndex(int r, int c) const;
+
+    bool solveSat();
+    void place(int r, int c, int val);
+    void unplace(int r, int c, int val);
+
+    void setShape(int size);
+    void clearCages();
+    bool buildCages(const std::vector<Cage> &cages);
+    int searchMasks(int limit, bool keepFirst);
+    bool fillRandom(int pos, uint32_t &rng);
 };
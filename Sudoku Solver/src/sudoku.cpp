@@ -0,0 +1,80 @@
+#include "sudoku.h"
+#include "SudokuEngine.h"
+
+namespace {
+
+bool validSize(int size) {
+    return size == 6 || size == 9 || size == 12;
+}
+
+// copies cells into a MaxSize grid, rejecting out-of-range values
+int loadGrid(const int *cells, int size,
+             int grid[SudokuEngine::MaxSize][SudokuEngine::MaxSize]) {
+    if (!cells || !validSize(size)) return SUDOKU_INVALID_ARGUMENT;
+
+    for (int r = 0; r < size; ++r) {
+        for (int c = 0; c < size; ++c) {
+            int val = cells[r * size + c];
+            if (val < 0 || val > size) return SUDOKU_INVALID_ARGUMENT;
+            grid[r][c] = val;
+        }
+    }
+    return SUDOKU_OK;
+}
+
+void storeGrid(const SudokuEngine &engine, int size, int *out) {
+    int grid[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    engine.getGrid(grid);
+    for (int r = 0; r < size; ++r)
+        for (int c = 0; c < size; ++c)
+            out[r * size + c] = grid[r][c];
+}
+
+} // namespace
+
+extern "C" {
+
+int sudoku_api_version(void) {
+    return SUDOKU_API_VERSION;
+}
+
+int sudoku_solve(const int *cells, int size, int *out) {
+    if (!out) return SUDOKU_INVALID_ARGUMENT;
+
+    int grid[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    int rc = loadGrid(cells, size, grid);
+    if (rc != SUDOKU_OK) return rc;
+
+    SudokuEngine engine;
+    engine.setBackend(SudokuEngine::Backend::Masks);
+    if (!engine.loadPuzzle(grid, size)) return SUDOKU_INVALID_GRID;
+    if (!engine.solve(size)) return SUDOKU_NO_SOLUTION;
+
+    storeGrid(engine, size, out);
+    return SUDOKU_OK;
+}
+
+int sudoku_count(const int *cells, int size, int limit, int *count) {
+    if (!count || limit < 1) return SUDOKU_INVALID_ARGUMENT;
+
+    int grid[SudokuEngine::MaxSize][SudokuEngine::MaxSize]{};
+    int rc = loadGrid(cells, size, grid);
+    if (rc != SUDOKU_OK) return rc;
+
+    SudokuEngine engine;
+    if (!engine.loadPuzzle(grid, size)) return SUDOKU_INVALID_GRID;
+    *count = engine.countSolutions(limit);
+    return SUDOKU_OK;
+}
+
+int sudoku_generate(int size, unsigned int seed, int target_givens, int *out) {
+    if (!out || !validSize(size) || target_givens < 0)
+        return SUDOKU_INVALID_ARGUMENT;
+
+    SudokuEngine engine;
+    engine.generate(size, seed, target_givens);
+    storeGrid(engine, size, out);
+    return SUDOKU_OK;
+}
+
+} // extern "C"
@@ -0,0 +1,61 @@
+#ifndef SUDOKU_H
+#define SUDOKU_H
+
+/*
+ * Stable C interface to the sudoku core (no Qt, no heap allocation).
+ *
+ * Grids are size * size ints in row-major order, 0 for an empty cell.
+ * size must be 6, 9 or 12. Output buffers are provided by the caller and
+ * may alias the input.
+ */
+
+#if defined(_WIN32) && defined(SUDOKU_SHARED)
+#  if defined(SUDOKU_BUILDING)
+#    define SUDOKU_API __declspec(dllexport)
+#  else
+#    define SUDOKU_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define SUDOKU_API __attribute__((visibility("default")))
+#else
+#  define SUDOKU_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUDOKU_API_VERSION 1
+
+enum {
+    SUDOKU_OK               =  0,
+    SUDOKU_NO_SOLUTION      =  1,
+    SUDOKU_INVALID_ARGUMENT = -1,  /* bad size, null buffer, value out of range */
+    SUDOKU_INVALID_GRID     = -2   /* givens conflict with each other */
+};
+
+/* returns SUDOKU_API_VERSION of the library actually loaded */
+SUDOKU_API int sudoku_api_version(void);
+
+/*
+ * solves cells into out (size * size ints) with the most-constrained-cell
+ * search; a grid with several solutions gets one of them
+ */
+SUDOKU_API int sudoku_solve(const int *cells, int size, int *out);
+
+/* stores min(number of solutions, limit) into *count */
+SUDOKU_API int sudoku_count(const int *cells, int size, int limit, int *count);
+
+/*
+ * writes a puzzle with a unique solution into out; clues are removed until
+ * target_givens is reached or no further clue can go. The same seed always
+ * yields the same puzzle.
+ */
+SUDOKU_API int sudoku_generate(int size, unsigned int seed, int target_givens,
+                               int *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SUDOKU_H */